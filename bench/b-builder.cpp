@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "xmlutils/platform.h"
+#include "xmlutils/dom_document.h"
+#include "bench_support.h"
+
+// 5. Building documents of range(0) elements
+
+namespace {
+
+void fill_batch(xerces::node_batch& batch, int64_t count) {
+    char address[32];
+    batch.reserve(static_cast<size_t>(count), static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; ++i) {
+        std::snprintf(address, sizeof(address), "10.0.%d.%d"
+                , static_cast<int>(i / 256 % 256), static_cast<int>(i % 256));
+        batch.add("server_settings", address).attribute("line_color", "0xffccff00");
+    }
+}
+
+}
+
+// 5.1 Element per call
+static void BM_build_per_node(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    char address[32];
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::dom_document doc;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            std::snprintf(address, sizeof(address), "10.0.%d.%d"
+                    , static_cast<int>(i / 256 % 256), static_cast<int>(i % 256));
+            DOMElement* n = doc.create_node("server_settings", address);
+            doc.create_attribute(n, "line_color", "0xffccff00");
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_build_per_node)->Arg(1000)->Arg(100000);
+
+// 5.2 All elements in one call, batch is filled in the loop
+static void BM_build_batch(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::dom_document doc;
+        xerces::node_batch batch;
+        fill_batch(batch, state.range(0));
+        doc.append_nodes(batch);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_build_batch)->Arg(1000)->Arg(100000);
+
+// 5.3 Parse of the same document, the target for building
+static void BM_build_parse_equivalent(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    std::string xml;
+    {
+        xerces::dom_document doc;
+        xerces::node_batch batch;
+        fill_batch(batch, state.range(0));
+        doc.append_nodes(batch);
+        doc.serializer().set_format(xerces::dom_serializer::compact);
+        doc.save_to(xml);
+    }
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::dom_document doc(reinterpret_cast<const XMLByte*>(xml.data()), xml.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(xml.size()));
+}
+BENCHMARK(BM_build_parse_equivalent)->Arg(1000)->Arg(100000);
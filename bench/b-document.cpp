@@ -0,0 +1,212 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "xmlutils/platform.h"
+#include "xmlutils/dom_document.h"
+#include "xmlutils/xpath.h"
+#include "xmlutils/snapshot.h"
+#include "bench_support.h"
+
+// 6. Documents generated from tests/t-sample.xml,
+// argument is document size in bytes
+
+// 6.1 Open file
+static void BM_document_open(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    const std::string file = bench::sample_file(bytes);
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::dom_document doc(file.c_str());
+        benchmark::DoNotOptimize(&doc);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bench::sample_data(bytes).size()));
+}
+BENCHMARK(BM_document_open)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.2 Open memory buffer
+static void BM_document_open_memory(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    const std::string& xml = bench::sample_data(static_cast<size_t>(state.range(0)));
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::dom_document doc(reinterpret_cast<const XMLByte*>(xml.data()), xml.size());
+        benchmark::DoNotOptimize(&doc);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(xml.size()));
+}
+BENCHMARK(BM_document_open_memory)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.3 Save to memory buffer
+static void BM_document_save_memory(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    xerces::dom_document doc(bench::sample_file(static_cast<size_t>(state.range(0))).c_str());
+    doc.serializer().set_format(xerces::dom_serializer::compact);
+    std::string xml;
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xml.clear();
+        doc.save_to(xml);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(xml.size()));
+}
+BENCHMARK(BM_document_save_memory)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.4 Save to file in place and replaced atomically
+static void save_file(benchmark::State& state, bool atomic) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    xerces::dom_document doc(bench::sample_file(static_cast<size_t>(state.range(0))).c_str());
+    std::string xml;
+    doc.save_to(xml);
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        doc.save_document_as("b-save.xml", atomic);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(xml.size()));
+}
+
+static void BM_document_save_file(benchmark::State& state) {
+    save_file(state, false);
+}
+BENCHMARK(BM_document_save_file)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_document_save_file_atomic(benchmark::State& state) {
+    save_file(state, true);
+}
+BENCHMARK(BM_document_save_file_atomic)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.5 Query with document parse, cold evaluator
+static void BM_xpath_cold(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xpath_component);
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    const std::string file = bench::sample_file(bytes);
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::xpath x(file);
+        benchmark::DoNotOptimize(x.evaluate("/root/color_settings[1]/@line_color", "/").size());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bench::sample_data(bytes).size()));
+}
+BENCHMARK(BM_xpath_cold)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.6 Query of parsed document, compiled expression is cached
+static void BM_xpath_warm(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xpath_component);
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    xerces::xpath x(bench::sample_file(bytes));
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x.evaluate("/root/color_settings[1]/@line_color", "/").size());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bench::sample_data(bytes).size()));
+}
+BENCHMARK(BM_xpath_warm)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.7 Open file validated against preloaded schema
+static void BM_document_open_validated(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    xerces::grammar_cache grammars;
+    grammars.preload_schema("t-sample.xsd");
+    grammars.lock();
+    const xerces::parse_options options = xerces::parse_options::validated(&grammars);
+
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    const std::string file = bench::sample_file(bytes);
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::dom_document doc(file.c_str(), options);
+        benchmark::DoNotOptimize(&doc);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bench::sample_data(bytes).size()));
+}
+BENCHMARK(BM_document_open_validated)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.8 Lookup by element name and attribute value in document indexes
+static void BM_document_index_lookup(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    xerces::dom_document doc(bench::sample_file(bytes).c_str());
+    doc.enable_index(std::vector<std::string>(1, "line_color"));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(doc.elements_by_name("server_settings").size());
+        benchmark::DoNotOptimize(doc.elements_by_attribute("line_color", "0xffccff00").size());
+    }
+}
+BENCHMARK(BM_document_index_lookup)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.9 Query of absolute path answered by the path index
+static void BM_xpath_path_index(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xpath_component);
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    xerces::xpath x(bench::sample_file(bytes));
+    x.enable_path_index();
+    state.counters["index_bytes"] = static_cast<double>(x.path_index_memory());
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x.evaluate("/root/color_settings/@line_color", "/").size());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bench::sample_data(bytes).size()));
+}
+BENCHMARK(BM_xpath_path_index)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.10 Query of simple path by the native evaluator
+static void BM_xpath_native(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xpath_component);
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    xerces::xpath x(bench::sample_file(bytes));
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x.evaluate("//color_settings/@line_color", "/").size());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bench::sample_data(bytes).size()));
+}
+BENCHMARK(BM_xpath_native)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.11 The same query by Xalan, the baseline for 6.10
+static void BM_xpath_native_disabled(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xpath_component);
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    xerces::xpath x(bench::sample_file(bytes));
+    x.enable_native(false);
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x.evaluate("//color_settings/@line_color", "/").size());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bench::sample_data(bytes).size()));
+}
+BENCHMARK(BM_xpath_native_disabled)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.12 Open compiled snapshot and query it, the alternative to 6.1
+static void BM_snapshot_open(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    const std::string file = bench::sample_file(bytes);
+    const std::string snap = file + ".snap";
+    xerces::snapshot::compile(file.c_str(), snap.c_str());
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::snapshot settings(snap.c_str(), file.c_str());
+        benchmark::DoNotOptimize(settings.evaluate("/root/color_settings/@line_color").size());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bench::sample_data(bytes).size()));
+}
+BENCHMARK(BM_snapshot_open)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
+
+// 6.13 Open file keeping one subtree, the alternative to 6.1
+static void BM_document_open_projected(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    const std::string file = bench::sample_file(bytes);
+    xerces::projection colors;
+    colors.add("/root/color_settings");
+    xerces::parse_options options;
+    options._projection = &colors;
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::dom_document doc(file.c_str(), options);
+        benchmark::DoNotOptimize(&doc);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bench::sample_data(bytes).size()));
+}
+BENCHMARK(BM_document_open_projected)->Apply(bench::sample_sizes)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,27 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "xmlutils/platform.h"
+#include "xmlutils/xpath_executor.h"
+
+// 3. Parallel queries over many files, argument is number of threads
+
+// 3.1 Same batch against 256 files
+static void BM_executor_run(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xpath_component);
+    const std::vector<std::string> files(256, "t-sample.xml");
+    std::vector<xerces::xpath::query_t> queries;
+    queries.push_back(xerces::xpath::query_t("/root/server_settings/text()", "/"));
+    queries.push_back(xerces::xpath::query_t("/root/color_settings/@line_color", "/"));
+
+    xerces::xpath_executor executor(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        xerces::xpath_executor::result_t res = executor.run(files, queries);
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(state.iterations() * files.size());
+    state.counters["stolen"] = static_cast<double>(executor.stolen());
+}
+BENCHMARK(BM_executor_run)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
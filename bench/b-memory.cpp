@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+
+#include "xmlutils/platform.h"
+#include "xmlutils/dom_document.h"
+#include "xmlutils/xpath.h"
+#include "bench_support.h"
+
+// 2. Global memory manager against per-document arena,
+// argument is xerces::memory_policy
+
+// 2.1 Load and release a small document
+static void BM_memory_open_document(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    const xerces::memory_policy policy = static_cast<xerces::memory_policy>(state.range(0));
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::dom_document doc("t-sample.xml", policy);
+        benchmark::DoNotOptimize(doc.memory_manager());
+    }
+}
+BENCHMARK(BM_memory_open_document)
+    ->Arg(xerces::global_memory)->Arg(xerces::arena_memory);
+
+// 2.2 Build and release a document of range(1) nodes
+static void BM_memory_build_document(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    const xerces::memory_policy policy = static_cast<xerces::memory_policy>(state.range(0));
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::dom_document doc(policy);
+        for (int64_t i = 0; i < state.range(1); ++i) {
+            DOMElement* n = doc.create_node("server_settings", "127.0.0.1");
+            doc.create_attribute(n, "line_color", "0xffccff00");
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_memory_build_document)
+    ->Args({xerces::global_memory, 1000})->Args({xerces::arena_memory, 1000});
+
+// 2.3 Parse a document for queries
+static void BM_memory_xpath_load(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xpath_component);
+    const xerces::memory_policy policy = static_cast<xerces::memory_policy>(state.range(0));
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::xpath x("t-sample.xml", policy);
+        benchmark::DoNotOptimize(&x);
+    }
+}
+BENCHMARK(BM_memory_xpath_load)
+    ->Arg(xerces::global_memory)->Arg(xerces::arena_memory);
@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "xmlutils/platform.h"
+#include "xmlutils/xpath.h"
+
+// 4. Startup latency: evaluator with the platform initialized
+// for every object and with one process-wide guard
+
+// 4.1 Every evaluator initializes and terminates the platform
+static void BM_startup_per_object(benchmark::State& state) {
+    for (auto _ : state) {
+        xerces::platform platform(xerces::platform::transformer_component);
+        xerces::xpath x("t-sample.xml");
+        benchmark::DoNotOptimize(x.evaluate("/root/stub_settings", "/").size());
+    }
+}
+BENCHMARK(BM_startup_per_object);
+
+// 4.2 Platform is held by the process, evaluators only take a reference
+static void BM_startup_shared(benchmark::State& state) {
+    xerces::platform process(xerces::platform::transformer_component);
+    for (auto _ : state) {
+        xerces::platform platform(xerces::platform::transformer_component);
+        xerces::xpath x("t-sample.xml");
+        benchmark::DoNotOptimize(x.evaluate("/root/stub_settings", "/").size());
+    }
+}
+BENCHMARK(BM_startup_shared);
+
+// 4.3 Cost of the guard itself
+static void BM_platform_guard(benchmark::State& state) {
+    xerces::platform process(xerces::platform::transformer_component);
+    for (auto _ : state) {
+        xerces::platform platform;
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_platform_guard)->Threads(1)->Threads(4);
@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+#include "bench_support.h"
+
+namespace {
+
+const char* const head =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\" ?>\n"
+    "<root>\n"
+    "  <stub_settings/>\n";
+
+const char* const tail = "</root>\n";
+
+std::string generate(size_t bytes) {
+    std::string xml(head);
+    xml.reserve(bytes + 256);
+
+    const size_t tail_size = std::char_traits<char>::length(tail);
+    char line[128];
+    for (size_t i = 0; xml.size() + tail_size < bytes; ++i) {
+        std::snprintf(line, sizeof(line)
+                , "  <server_settings>192.168.%u.%u</server_settings>\n"
+                , static_cast<unsigned>(i / 256 % 256), static_cast<unsigned>(i % 256));
+        xml += line;
+        if (i % 2 == 1)
+            xml += "  <color_settings line_color=\"0xffccff00\" background_color=\"0xff00cc00\"/>\n";
+    }
+    xml += tail;
+    return xml;
+}
+
+}
+
+const std::string& bench::sample_data(size_t bytes) {
+    static std::map<size_t, std::string> samples;
+    std::map<size_t, std::string>::iterator it = samples.find(bytes);
+    if (it == samples.end())
+        it = samples.insert(std::make_pair(bytes, generate(bytes))).first;
+    return it->second;
+}
+
+std::string bench::sample_file(size_t bytes) {
+    static std::set<size_t> written;
+    std::ostringstream name;
+    name << "b-sample-" << bytes << ".xml";
+    if (written.insert(bytes).second) {
+        const std::string& xml = sample_data(bytes);
+        std::ofstream out(name.str().c_str(), std::ios::binary | std::ios::trunc);
+        out.write(xml.data(), static_cast<std::streamsize>(xml.size()));
+    }
+    return name.str();
+}
+
+void bench::sample_sizes(benchmark::internal::Benchmark* b) {
+    b->Arg(1 << 10)->Arg(1 << 20)->Arg(100 << 20);
+}
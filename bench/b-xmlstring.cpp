@@ -0,0 +1,85 @@
+#include <cstring>
+#include <string>
+#include <benchmark/benchmark.h>
+
+#include "xmlutils/platform.h"
+#include "xmlutils/dom_document.h"
+#include "xmlutils/xmlstring.h"
+#include "bench_support.h"
+
+// 1. xerces::string conversions
+
+// 1.1 Short ASCII name, as element and attribute names are
+static void BM_string_ascii_name(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::string x("server_settings");
+        benchmark::DoNotOptimize(x.get_wchar());
+    }
+}
+BENCHMARK(BM_string_ascii_name);
+
+// 1.2 Long ASCII value goes to the heap
+static void BM_string_ascii_long(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    const std::string value(static_cast<size_t>(state.range(0)), 'x');
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::string x(value.c_str());
+        benchmark::DoNotOptimize(x.get_wchar());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_string_ascii_long)->Arg(256)->Arg(4096);
+
+// 1.3 UTF-8 value without transcoder
+static void BM_string_utf8(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    const char* value = "\xd0\xbd\xd0\xb0\xd1\x81\xd1\x82\xd1\x80\xd0\xbe\xd0\xb9\xd0\xba\xd0\xb8";
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        xerces::string x(value, xerces::string::utf8);
+        benchmark::DoNotOptimize(x.get_wchar());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::strlen(value)));
+}
+BENCHMARK(BM_string_utf8);
+
+// 1.4 Round trip back to std::string
+static void BM_string_get_string(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    xerces::string x("192.168.68.1");
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        std::string s = x.get_string();
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+BENCHMARK(BM_string_get_string);
+
+// 1.5 Allocations per node and attribute created
+static void BM_create_node_allocations(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    xerces::dom_document doc;
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        DOMElement* n = doc.create_node("server_settings", "127.0.0.1");
+        doc.create_attribute(n, "line_color", "0xffccff00");
+    }
+}
+BENCHMARK(BM_create_node_allocations);
+
+// 1.6 Allocations per node and attribute created with interned names
+static void BM_create_node_interned(benchmark::State& state) {
+    xerces::platform platform(xerces::platform::xerces_component);
+    xerces::dom_document doc;
+    const xerces::name_table::name srv = doc.intern("server_settings");
+    const xerces::name_table::name color = doc.intern("line_color");
+    bench::allocation_counter allocs(state);
+    for (auto _ : state) {
+        DOMElement* n = doc.create_node(srv, "127.0.0.1");
+        doc.create_attribute(n, color, "0xffccff00");
+    }
+}
+BENCHMARK(BM_create_node_interned);
@@ -0,0 +1,60 @@
+/* 
+ * File:   bench_support.h
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 16:05
+ */
+
+#ifndef BENCH_SUPPORT_H
+#define	BENCH_SUPPORT_H
+
+#include <cstddef>
+#include <string>
+#include <benchmark/benchmark.h>
+
+namespace bench {
+
+/** @brief Number of global operator new calls since process start.<br>
+ * Xerces default memory manager allocates with operator new too,
+ * so it counts both library and standard library allocations.
+ */
+size_t allocations();
+
+/** @brief Counts allocations made in the benchmark loop and reports them
+ * as "allocs/op" when destroyed. */
+class allocation_counter {
+public:
+    explicit allocation_counter(benchmark::State& state)
+    : _state(state)
+    , _start(allocations()) { }
+
+    ~allocation_counter() {
+        _state.counters["allocs/op"] = benchmark::Counter(
+                static_cast<double>(allocations() - _start),
+                benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State& _state;
+    size_t _start;
+};
+
+/** @brief XML document shaped like tests/t-sample.xml: root with
+ * stub, server and color settings repeated up to about
+ * <code>bytes</code> size.<br>
+ * Samples are generated once per process and kept in memory.
+ */
+const std::string& sample_data(size_t bytes);
+
+/** @brief File with <code>sample_data(bytes)</code> in the working
+ * directory, written once per process.
+ * @return file name
+ */
+std::string sample_file(size_t bytes);
+
+/** @brief Add sample sizes 1KB, 1MB and 100MB as benchmark arguments */
+void sample_sizes(benchmark::internal::Benchmark* b);
+
+}
+
+#endif	/* BENCH_SUPPORT_H */
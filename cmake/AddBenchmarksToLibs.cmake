@@ -0,0 +1,13 @@
+
+function(AddBenchmarksToLibs TargetName Libs BenchSources)
+    find_package(benchmark REQUIRED)
+
+    add_executable(${TargetName} ${BenchSources})
+
+    foreach(Lib ${Libs})
+      message("Link benchmark library: " ${Lib})
+      target_link_libraries(${TargetName} ${Lib})
+    endforeach(Lib)
+
+    target_link_libraries(${TargetName} benchmark::benchmark)
+endfunction(AddBenchmarksToLibs)
@@ -0,0 +1,112 @@
+/* 
+ * File:   arena_memory_manager.h
+ * Author: ycherkasov
+ *
+ * Created on 19 Октябрь 2026 г., 13:15
+ */
+
+#ifndef ARENA_MEMORY_MANAGER_H
+#define	ARENA_MEMORY_MANAGER_H
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <xercesc/framework/MemoryManager.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief Memory policy of documents and evaluators */
+enum memory_policy {
+    /** @brief Use Xerces global memory manager */
+    global_memory,
+    /** @brief Use own arena released in bulk with the owner */
+    arena_memory
+};
+
+/** @brief Default memory policy, arena if XMLUTILS_ARENA_MEMORY is defined */
+#ifdef XMLUTILS_ARENA_MEMORY
+const memory_policy default_memory_policy = arena_memory;
+#else
+const memory_policy default_memory_policy = global_memory;
+#endif
+
+/** @brief This class implements arena Xerces memory manager.<br>
+ * Memory is taken from large blocks by pointer bump, and
+ * <code>deallocate()</code> does nothing: all the memory is released
+ * at once by <code>reset()</code> or destruction. Parser, DOM and
+ * transcoding temporaries of one document don't touch the global heap,
+ * so there is no fragmentation and no allocator contention across threads.
+ * An arena is not thread-safe, it is owned by one document.
+ * @code
+ * xerces::dom_document domDocument("settings.xml", xerces::arena_memory);
+ * @endcode
+ */
+class arena_memory_manager : public MemoryManager, boost::noncopyable {
+public:
+
+    /** @brief Default arena block size */
+    static const size_t default_block_size = 64 * 1024;
+
+    
+    /** @brief Arena constructor<br>
+     * @param block_size size of blocks taken from the global heap,
+     * larger requests get dedicated blocks
+     *  */
+    explicit arena_memory_manager(size_t block_size = default_block_size);
+
+    virtual ~arena_memory_manager();
+
+    
+    /** @brief Allocate memory from the current block */
+    virtual void* allocate(size_t size);
+
+    
+    /** @brief Memory is released in bulk, so it does nothing */
+    virtual void deallocate(void* p);
+
+#if _XERCES_VERSION >= 30000
+    virtual MemoryManager* getExceptionMemoryManager() {
+	return XMLPlatformUtils::fgMemoryManager;
+    }
+#endif
+
+    
+    /** @brief Release all memory at once.<br>
+     * All objects allocated from the arena must be already destroyed.
+     *  */
+    void reset();
+
+    
+    /** @return bytes given out since construction or last reset */
+    size_t allocated() const {
+	return _allocated;
+    }
+
+    
+    /** @return bytes taken from the global heap */
+    size_t reserved() const {
+	return _reserved;
+    }
+
+private:
+
+    /** @brief Start a new block for <code>size</code> bytes at least */
+    char* grow(size_t size);
+
+    /** @brief Blocks taken from the global heap */
+    std::vector<char*> _blocks;
+
+    /** @brief Free space of the current block */
+    char* _current;
+    char* _end;
+
+    size_t _block_size;
+    size_t _allocated;
+    size_t _reserved;
+};
+
+}
+
+#endif	/* ARENA_MEMORY_MANAGER_H */
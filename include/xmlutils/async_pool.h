@@ -0,0 +1,205 @@
+/* 
+ * File:   async_pool.h
+ * Author: ycherkasov
+ *
+ * Created on 20 Октябрь 2026 г., 10:15
+ */
+
+#ifndef ASYNC_POOL_H
+#define	ASYNC_POOL_H
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/future.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include "xmlutils/platform.h"
+#include "xmlutils/dom_document.h"
+#include "xmlutils/xpath.h"
+
+namespace xerces {
+
+/** @brief This class implements a bounded worker pool for asynchronous
+ * document loads and queries.<br>
+ * Every call queues a task and returns at once with a future, or calls
+ * the completion callback on a worker thread. Several workers overlap
+ * file I/O and parse of one document with evaluation of another.
+ * The queue is bounded: a call blocks while it is full.
+ * Every worker keeps its own <code>xpath</code> evaluator for file
+ * queries. Errors are delivered as <code>std::runtime_error</code>.
+ * Pending tasks are finished on destruction.
+ * @code
+ *  xerces::async_pool pool(4);
+ *  boost::unique_future<xerces::async_pool::document_ptr> settings
+ *      = pool.open_document_async("settings.xml");
+ *  boost::unique_future<xerces::xpath::batch_result_t> colors
+ *      = pool.evaluate_async("colors.xml", queries);
+ *  xerces::async_pool::document_ptr doc = settings.get();
+ *  xerces::xpath::batch_result_t res = colors.get();
+ * @endcode
+ */
+class async_pool : boost::noncopyable {
+public:
+
+    /** @brief Loaded document shared with the caller */
+    typedef boost::shared_ptr<dom_document> document_ptr;
+
+    /** @brief Load completion: document or error message */
+    typedef boost::function<void(const document_ptr&, const std::string&)> open_callback_t;
+
+    /** @brief Query completion: results or error message */
+    typedef boost::function<void(const xpath::batch_result_t&, const std::string&)> evaluate_callback_t;
+
+    /** @brief Default number of queued tasks */
+    static const size_t default_max_queue = 64;
+
+
+    /** @brief Pool constructor<br>
+     * @param threads number of workers, 0 means number of hardware threads
+     * @param max_queue number of queued tasks before calls block
+     *  */
+    explicit async_pool(size_t threads = 0
+            , size_t max_queue = default_max_queue);
+
+    /** @brief Finish queued tasks and stop workers */
+    ~async_pool();
+
+
+    /** @brief Load document asynchronously<br>
+     * @param filename XML file name
+     * @return future of loaded document
+     *  */
+    boost::unique_future<document_ptr> open_document_async(const std::string& filename);
+
+    /** @brief Load document and call <code>done</code> on a worker thread<br>
+     * The callback must not wait for other tasks of the pool.
+     * @param filename XML file name
+     * @param done completion callback
+     *  */
+    void open_document_async(const std::string& filename, const open_callback_t& done);
+
+
+    /** @brief Parse file and evaluate queries asynchronously<br>
+     * @param filename XML file name
+     * @param queries list of (expression, context) pairs
+     * @return future of one result set per query
+     *  */
+    boost::unique_future<xpath::batch_result_t> evaluate_async(const std::string& filename
+            , const std::vector<xpath::query_t>& queries);
+
+    /** @brief Evaluate queries against loaded document asynchronously<br>
+     * The document is queried in place and must not be changed until
+     * the result is ready.
+     * @param document loaded document
+     * @param queries list of (expression, context) pairs
+     * @return future of one result set per query
+     *  */
+    boost::unique_future<xpath::batch_result_t> evaluate_async(const document_ptr& document
+            , const std::vector<xpath::query_t>& queries);
+
+    /** @brief Parse file, evaluate queries and call <code>done</code>
+     * on a worker thread<br>
+     * @param filename XML file name
+     * @param queries list of (expression, context) pairs
+     * @param done completion callback
+     *  */
+    void evaluate_async(const std::string& filename
+            , const std::vector<xpath::query_t>& queries
+            , const evaluate_callback_t& done);
+
+
+    /** @brief Number of worker threads */
+    size_t threads() const {
+        return _thread_count;
+    }
+
+    /** @brief Number of queued tasks, not started yet */
+    size_t pending() const;
+
+private:
+
+    /** @brief Queued task */
+    typedef boost::function<void()> task_t;
+
+    /** @brief Queue task, block while the queue is full */
+    void post(const task_t& task);
+
+    /** @brief Worker thread body */
+    void work();
+
+    /** @brief Queue function call with its result delivered by future */
+    template <typename R>
+    boost::unique_future<R> submit(const boost::function<R()>& f) {
+        boost::shared_ptr<boost::packaged_task<R> > task(new boost::packaged_task<R>(f));
+        boost::unique_future<R> result = task->get_future();
+        post(boost::bind(&async_pool::run_task<R>, task));
+        return boost::unique_future<R>(boost::move(result));
+    }
+
+    /** @brief Run packaged task */
+    template <typename R>
+    static void run_task(const boost::shared_ptr<boost::packaged_task<R> >& task) {
+        (*task)();
+    }
+
+    /** @brief Load document, Xerces errors are thrown as std exceptions */
+    static document_ptr open(const std::string& filename);
+
+    /** @brief Evaluate queries with the worker evaluator */
+    xpath::batch_result_t evaluate_file(const std::string& filename
+            , const std::vector<xpath::query_t>& queries);
+
+    /** @brief Evaluate queries against loaded document */
+    static xpath::batch_result_t evaluate_document(const document_ptr& document
+            , const std::vector<xpath::query_t>& queries);
+
+    /** @brief Load document and report it to callback */
+    static void open_notify(const std::string& filename, const open_callback_t& done);
+
+    /** @brief Evaluate queries and report results to callback */
+    void evaluate_notify(const std::string& filename
+            , const std::vector<xpath::query_t>& queries
+            , const evaluate_callback_t& done);
+
+    /** @brief Platform is held while workers run */
+    platform _platform;
+
+    /** @brief Queued tasks */
+    std::deque<task_t> _queue;
+
+    /** @brief Maximum number of queued tasks */
+    const size_t _max_queue;
+
+    /** @brief Queue lock */
+    mutable boost::mutex _mutex;
+
+    /** @brief Signalled when a task is queued or pool stops */
+    boost::condition_variable _not_empty;
+
+    /** @brief Signalled when a task is taken from the queue */
+    boost::condition_variable _not_full;
+
+    /** @brief Workers finish queued tasks and exit */
+    bool _stopping;
+
+    /** @brief Evaluator of the worker thread, created on first query */
+    boost::thread_specific_ptr<xpath> _evaluator;
+
+    /** @brief Number of workers */
+    size_t _thread_count;
+
+    /** @brief Workers */
+    boost::thread_group _threads;
+};
+
+}
+
+#endif	/* ASYNC_POOL_H */
+
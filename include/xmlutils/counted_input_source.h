@@ -0,0 +1,44 @@
+/* 
+ * File:   counted_input_source.h
+ * Author: ycherkasov
+ *
+ * Created on 26 Октябрь 2026 г., 12:30
+ */
+
+#ifndef COUNTED_INPUT_SOURCE_H
+#define	COUNTED_INPUT_SOURCE_H
+
+#include <boost/scoped_ptr.hpp>
+#include <xercesc/sax/InputSource.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief This class implements input source which adds bytes read
+ * by the parser to <code>stats::bytes_read</code>.<br>
+ * Bytes are counted as the parser reads them, so size of a parsed
+ * file is known without extra <code>stat()</code> of it.
+ * @code
+ * xerces::counted_input_source source(new LocalFileInputSource(name));
+ * parser.parse(source);
+ * @endcode
+ */
+class counted_input_source : public InputSource {
+public:
+
+    /** @brief Wrap input source<br>
+     * @param source input source, adopted
+     *  */
+    explicit counted_input_source(InputSource* source);
+
+    /** @brief Stream of the wrapped source which counts read bytes */
+    virtual BinInputStream* makeStream() const;
+
+private:
+    boost::scoped_ptr<InputSource> _source;
+};
+
+}
+
+#endif	/* COUNTED_INPUT_SOURCE_H */
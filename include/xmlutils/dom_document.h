@@ -9,15 +9,27 @@
 #define	DOM_DOCUMENT_H
 
 #include <iostream>
+#include <vector>
 #include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/unordered_set.hpp>
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/dom/DOMWriter.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/OutOfMemoryException.hpp>
 #include <xercesc/framework/LocalFileFormatTarget.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
 
 #include "xmlutils/xmlstring.h"
+#include "xmlutils/arena_memory_manager.h"
+#include "xmlutils/dom_parser_pool.h"
+#include "xmlutils/grammar_cache.h"
+#include "xmlutils/dom_serializer.h"
+#include "xmlutils/name_table.h"
+#include "xmlutils/node_batch.h"
+#include "xmlutils/node_index.h"
+#include "xmlutils/projection.h"
 
 namespace xerces {
 
@@ -72,9 +84,13 @@ public:
      * domDocument.create_attribute(color_settings, "background", "0xFFFFCCFF");
      * domDocument.save_document_as("settings.xml");
      * @endcode
+     * @param policy global or arena memory for the document
      */
-    dom_document()
-    : _doc(create_dom_document("root")) {
+    explicit dom_document(memory_policy policy = default_memory_policy)
+    : _arena(create_arena(policy))
+    , _doc(create_dom_document("root", memory_manager()))
+    , _parser_pool(0)
+    , _revision(0) {
     }
 
     
@@ -87,12 +103,99 @@ public:
      * , with LS (load and save support) and DOM 3.0 level support.
      *
      * @param filename XML file name
+     * @param policy global or arena memory for the document
      */
-    dom_document(const char* filename)
-    : _filename(filename) {
+    dom_document(const char* filename
+	    , memory_policy policy = default_memory_policy)
+    : _arena(create_arena(policy))
+    , _filename(filename)
+    , _parser_pool(0)
+    , _revision(0) {
 	open_document(filename);
     }
 
+    
+    /** @brief Existing XML-document constructor with loading settings
+    //@{
+
+     * Construct a DOM-document from existing XML file.
+     *
+     * The file is loaded with given validation settings and grammars.
+     * @code
+     * xerces::dom_document domDocument("settings.xml"
+     *     , xerces::parse_options::validated(&grammars));
+     * @endcode
+     *
+     * @param filename XML file name
+     * @param options loading settings
+     * @param policy global or arena memory for the document
+     */
+    dom_document(const char* filename
+	    , const parse_options& options
+	    , memory_policy policy = default_memory_policy)
+    : _arena(create_arena(policy))
+    , _filename(filename)
+    , _parser_pool(0)
+    , _revision(0) {
+	open_document(filename, options);
+    }
+
+    
+    /** @brief Existing XML-document constructor with shared parsers
+    //@{
+
+     * Construct a DOM-document from existing XML file.
+     *
+     * The document is loaded with a parser checked out from the pool,
+     * and all following <code>open_document()</code> calls use the pool
+     * too. The pool must outlive the document loads.
+     * Pooled parsers use global memory, so the document does too.
+     * @code
+     * xerces::dom_parser_pool pool;
+     * xerces::dom_document domDocument("settings.xml", pool);
+     * @endcode
+     *
+     * @param filename XML file name
+     * @param pool shared parsers pool
+     * @param options loading settings, grammars of the pool are used
+     * if they are not set
+     */
+    dom_document(const char* filename, dom_parser_pool& pool
+	    , const parse_options& options = parse_options())
+    : _filename(filename)
+    , _parser_pool(&pool)
+    , _revision(0) {
+	open_document(filename, options);
+    }
+
+    
+    /** @brief In-memory XML-document constructor
+    //@{
+
+     * Construct a DOM-document from XML bytes without copying them.
+     *
+     * The buffer may be a received message or a <code>mapped_file</code>
+     * region, it must be alive while the constructor works only.
+     * The document has no related file name, use
+     * <code>save_document_as()</code> to save it.
+     * @code
+     * xerces::mapped_file file("settings.xml");
+     * xerces::dom_document domDocument(file.data(), file.size());
+     * @endcode
+     *
+     * @param data XML document bytes
+     * @param size buffer size in bytes, <code>std::length_error</code> is thrown
+     * above 4 GB
+     * @param policy global or arena memory for the document
+     */
+    dom_document(const XMLByte* data, size_t size
+	    , memory_policy policy = default_memory_policy)
+    : _arena(create_arena(policy))
+    , _parser_pool(0)
+    , _revision(0) {
+	open_document(data, size);
+    }
+
 protected:
 
     
@@ -101,7 +204,15 @@ protected:
      * don't use it without a special RAII wrapper:<br>
      * <code>xerces_auto_ptr<DOMDocument> wrapper(create_dom_document());</code>
      *  */
-    static DOMDocument* create_dom_document(const char* root);
+    static DOMDocument* create_dom_document(const char* root
+	    , MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager);
+
+    
+    /** @brief This static method returns a new arena for arena memory
+     * policy, NULL for global memory policy */
+    static arena_memory_manager* create_arena(memory_policy policy) {
+	return (policy == arena_memory) ? new arena_memory_manager : 0;
+    }
 
     
     /** @brief This static method returns a new DOMDocument object with LS support.<br>
@@ -111,31 +222,130 @@ protected:
      *  */
     static DOMDocument* create_ls_dom_document(const char* filename) ;
 
+    
+    /** @brief This method replaces current document by parsed one.<br>
+     * @param document parsed document, adopted
+     * @param arena arena of the parsed document, NULL for global memory,
+     * it is swapped with the current one, which is released by the caller
+     *  */
+    void replace_document(DOMDocument* document
+	    , boost::scoped_ptr<arena_memory_manager>& arena);
+
+    
+    /** @brief This method forgets changes after load or save */
+    void mark_clean() {
+	_changed.clear();
+    }
+
 public:
 
     
     /** @brief This method loads a new DOMDocument into object.<br> 
      * Existing object will be released without save, so,
      * you should save it before with method <code>save_document()</code> or
-     * <code>save_document_as()</code>
+     * <code>save_document_as()</code>. The arena, if any, is released
+     * in bulk before load.
+     * @param xml_filename XML file name
+     *  */
+    void open_document(const char* xml_filename) {
+	open_document(xml_filename, parse_options());
+    }
+
+    
+    /** @brief This method loads a new DOMDocument with loading settings.<br>
+     * Validation errors are thrown with <code>validate_always</code>
+     * scheme.
      * @param xml_filename XML file name
+     * @param options validation settings and grammars of this load
+     *  */
+    void open_document(const char* xml_filename, const parse_options& options);
+
+    
+    /** @brief This method loads a new DOMDocument from memory buffer.<br>
+     * The buffer is parsed in place without copying.
+     * Existing object will be released without save, related file name
+     * stays unchanged.
+     * @param data XML document bytes
+     * @param size buffer size in bytes, <code>std::length_error</code> is thrown
+     * above 4 GB
+     *  */
+    void open_document(const XMLByte* data, size_t size) {
+	open_document(data, size, parse_options());
+    }
+
+    
+    /** @brief This method loads a new DOMDocument from memory buffer
+     * with loading settings.<br>
+     * @param data XML document bytes
+     * @param size buffer size in bytes, <code>std::length_error</code> is thrown
+     * above 4 GB
+     * @param options validation settings and grammars of this load
      *  */
-    void open_document(const char* xml_filename);
+    void open_document(const XMLByte* data, size_t size, const parse_options& options);
+
+    
+    /** @brief This method sets parsers pool used by
+     * <code>open_document()</code><br>
+     * @param pool shared parsers pool, NULL to create a parser per load
+     *  */
+    void set_parser_pool(dom_parser_pool* pool) {
+	_parser_pool = pool;
+    }
 
     
     /** @brief This method saves current DOMDocument as an XML file<br>
      * It should be saved before with <code>save_document_as()</code> method
      * or opened as existing document, or it doesn't teake any effect.
+     * Clean document (not changed since load or save) is not written.
+     * @param atomic replace file through temporary file and rename,
+     * see <code>save_document_as()</code>
+     * @return number of changed subtrees written, 0 if nothing is saved
      *  */
-    void save_document();
+    size_t save_document(bool atomic = false);
 
     
     /** @brief This method saves current DOMDocument as an XML file with
      * the name produced.
      *
+     * It is always written, the document becomes clean.
+     * With <code>atomic</code> flag the document is written to
+     * a temporary file, which is renamed over the target, so readers
+     * never see a partial file. Symbolic link target is replaced
+     * by regular file then, and owner and ACL of the file are lost.
      * @param xml_filename XML file name
+     * @param atomic replace file through temporary file and rename
      *  */
-    void save_document_as(const char* xml_filename);
+    void save_document_as(const char* xml_filename, bool atomic = false);
+
+    
+    /** @brief This method appends current DOMDocument to memory buffer
+     *
+     * Use it to send the document without a file on disk.
+     * @param buffer output buffer, it is appended
+     * @return number of bytes written
+     *  */
+    size_t save_to(std::string& buffer);
+
+    
+    /** @brief This method writes current DOMDocument to file descriptor
+     *
+     * The descriptor (e.g. socket) is not closed.
+     * @param fd open file descriptor
+     * @return number of bytes written
+     *  */
+    size_t save_to(int fd);
+
+    
+    /** @brief Serializer used by save methods */
+    /** It is created on first save and reused, change its format
+     * or buffer size before save.
+     * @code
+     * domDocument.serializer().set_format(xerces::dom_serializer::compact);
+     * domDocument.save_to(message);
+     * @endcode
+     * @return document serializer, pretty format by default
+     *  */
+    dom_serializer& serializer();
 
     
     /** @brief This method creates new XML-node elsewhere in document hierarchy.*/
@@ -158,6 +368,47 @@ public:
 	    , DOMElement* parent_element = 0);
 
     
+    /** @brief This method creates new XML-node with interned name.*/
+    /** It works like <code>create_node()</code> with string name,
+     * but the name is transcoded once per document.
+     * @code
+     * xerces::name_table::name srv = domDocument.intern("server_settings");
+     * DOMElement* n1 = domDocument.create_node(srv, "127.0.0.1");
+     * DOMElement* n2 = domDocument.create_node(srv, "192.168.68.1");
+     * @endcode
+     * @param element_name interned name of node
+     * @param node_value string value of node - optional
+     * @param parent_element pointer to parent element, document root by default
+     * @return created node pointer
+     *  */
+    DOMElement* create_node(name_table::name element_name
+	    , const char* const node_value = 0
+	    , DOMElement* parent_element = 0);
+
+    
+    /** @brief This method appends all elements of the batch to one parent.*/
+    /** Elements are created in the batch order with their attributes
+     * and text values. Distinct names are interned once per call and
+     * there is a single exception boundary, so it is much cheaper than
+     * a <code>create_node()</code> and <code>create_attribute()</code>
+     * call per element. If an exception is thrown, elements created
+     * before it stay in the document.
+     * @code
+     * xerces::node_batch batch;
+     * batch.add("server_settings", "127.0.0.1").attribute("port", "8080");
+     * batch.add("server_settings", "192.168.68.1").attribute("port", "8081");
+     * domDocument.append_nodes(batch);
+     * @endcode
+     * @param batch element records
+     * @param parent_element pointer to parent element, document root by default
+     * @param created optional list to append created elements to
+     * @return number of created elements
+     *  */
+    size_t append_nodes(const node_batch& batch
+	    , DOMElement* parent_element = 0
+	    , std::vector<DOMElement*>* created = 0);
+
+    
     /** @brief This method creates new node attribute with new value*/
     /** If an attribute with the same name has already been created,
      * its value rewrites.
@@ -170,6 +421,17 @@ public:
 	    const char* const attr_value);
 
     
+    /** @brief This method creates new node attribute with interned name*/
+    /**
+     * @param node pointer to node containing the attribute
+     * @param attr_name interned attribute name
+     * @param attr_value string attribute value
+     *  */
+    void create_attribute(DOMElement* node,
+	    name_table::name attr_name,
+	    const char* const attr_value);
+
+    
     /** @brief This method sets the new attribute value */
     /** It completely duplucates functionality of
      * <code>create_attribute()</code>, but it is more
@@ -183,6 +445,137 @@ public:
 	    const char* const attr_value);
 
     
+    /** @brief This method sets the new attribute value with interned name */
+    /**
+     * @param node pointer to node containing the attribute
+     * @param attr_name interned attribute name
+     * @param attr_value string attribute value
+     *  */
+    void set_attribute_value(DOMElement* node,
+	    name_table::name attr_name,
+	    const char* const attr_value);
+
+    
+    /** @brief This method interns element or attribute name */
+    /** Builder methods transcode string names through the same table,
+     * so each distinct name is transcoded once per document.
+     * @param name element or attribute name
+     * @return name handle valid for the document lifetime
+     *  */
+    name_table::name intern(const char* const name) {
+	return _names.intern(name);
+    }
+
+    
+    /** @brief This method records a change made with native Xerces API */
+    /** Builder methods record their changes themselves. Call it after
+     * direct DOM edits of nodes returned by them, otherwise
+     * <code>save_document()</code> may skip the change.
+     * Indexes don't follow native edits, use <code>rebuild_index()</code>.
+     * @param node changed node, whole document if NULL
+     *  */
+    void mark_dirty(const DOMNode* node = 0);
+
+    
+    /** @brief This method builds element name and attribute value indexes */
+    /** Indexes are built in one pass over the document, rebuilt on
+     * every load and updated by builder methods and
+     * <code>delete_node()</code>. Lookups are hash lookups without XPath.
+     * @code
+     * std::vector<std::string> attributes(1, "id");
+     * domDocument.enable_index(attributes);
+     * const xerces::node_index::element_list_t& servers
+     *     = domDocument.elements_by_name("server_settings");
+     * const xerces::node_index::element_list_t& main
+     *     = domDocument.elements_by_attribute("id", "main");
+     * @endcode
+     * @param attributes names of indexed attributes, all if empty
+     *  */
+    void enable_index(const std::vector<std::string>& attributes
+	    = std::vector<std::string>());
+
+    
+    /** @brief This method drops indexes */
+    void disable_index() {
+	_index.reset();
+    }
+
+    
+    /** @brief This method rebuilds indexes after native Xerces edits */
+    void rebuild_index();
+
+    
+    /** @return true if indexes are enabled */
+    bool indexed() const {
+	return _index.get() != 0;
+    }
+
+    
+    /** @brief Elements with the name, in load and creation order */
+    /** Indexes must be enabled.
+     * @param element_name string name of element
+     * @return list of elements, empty if there are none; it is valid
+     * until the next change of the document
+     *  */
+    const node_index::element_list_t& elements_by_name(const char* const element_name) const;
+
+    
+    /** @brief Elements with the attribute value, in load and creation order */
+    /** Indexes must be enabled.
+     * @param attr_name string attribute name
+     * @param attr_value string attribute value
+     * @return list of elements, empty if there are none or the
+     * attribute is not indexed; it is valid until the next change
+     * of the document
+     *  */
+    const node_index::element_list_t& elements_by_attribute(const char* const attr_name
+	    , const char* const attr_value) const;
+
+    
+    /** @return true if document has been changed since load or save */
+    bool is_dirty() const {
+	return !_changed.empty();
+    }
+
+    
+    /** @return number of root element children changed since load or save,
+     * root element itself is counted for document-wide changes */
+    size_t changed_subtrees() const {
+	return _changed.size();
+    }
+
+    
+    /** @return modification counter, it is incremented by every change
+     * and load, and never reset */
+    size_t revision() const {
+	return _revision;
+    }
+
+    
+    /** @brief Native Xerces document */
+    /** Use <code>mark_dirty()</code> after changes made through it.
+     * @return document owned by the wrapper
+     *  */
+    DOMDocument* document() {
+	return _doc.get();
+    }
+
+    
+    /** @brief Native Xerces document (for constant objects) */
+    const DOMDocument* document() const {
+	return _doc.get();
+    }
+
+    
+    /** @brief Memory manager of the document */
+    /** @return document arena or Xerces global memory manager */
+    MemoryManager* memory_manager() const {
+	if (_arena)
+	    return _arena.get();
+	return XMLPlatformUtils::fgMemoryManager;
+    }
+
+    
     /** @brief Delete node by the pointer provided */
     /**
      * @param delete_node node pointer to delete
@@ -190,11 +583,32 @@ public:
     void delete_node(DOMElement* delete_node);
 
 private:
+    /** @brief Document memory for arena policy, must outlive the document */
+    boost::scoped_ptr<arena_memory_manager> _arena;
+
     /** @brief RAII-wrapper under the DOMDocument object */
     xerces_auto_ptr<DOMDocument> _doc;
 
     /** @brief Related XML-file name */
     std::string _filename;
+
+    /** @brief Shared parsers, a new parser per load if NULL */
+    dom_parser_pool* _parser_pool;
+
+    /** @brief Interned element and attribute names */
+    name_table _names;
+
+    /** @brief Reused serializer, created on first save */
+    boost::scoped_ptr<dom_serializer> _serializer;
+
+    /** @brief Modification counter */
+    size_t _revision;
+
+    /** @brief Changed root element children since load or save */
+    boost::unordered_set<const DOMNode*> _changed;
+
+    /** @brief Element indexes, NULL if not enabled */
+    boost::scoped_ptr<node_index> _index;
 };
 
 }
@@ -0,0 +1,257 @@
+/* 
+ * File:   dom_parser_pool.h
+ * Author: ycherkasov
+ *
+ * Created on 17 Октябрь 2026 г., 15:40
+ */
+
+#ifndef DOM_PARSER_POOL_H
+#define	DOM_PARSER_POOL_H
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax/ErrorHandler.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+class grammar_cache;
+class projection;
+
+/** @brief Loading settings of a single parse.<br>
+ * Defaults are the loading settings of the library: DTD validation
+ * if the document has one, no namespaces and no schema processing.
+ * Documents which must be valid use <code>validate_always</code>,
+ * then validation errors are thrown as <code>std::runtime_error</code>.
+ * With a grammar cache, grammars are taken from the cache instead of
+ * reading and compiling them on every parse. With a projection, only
+ * subtrees matched by its patterns become nodes.
+ * @code
+ * xerces::parse_options options = xerces::parse_options::validated(&grammars);
+ * domDocument.open_document("settings.xml", options);
+ * @endcode
+ */
+struct parse_options {
+
+    /** @brief Validation scheme */
+    enum validation_t {
+        /** @brief Never validate */
+        validate_never,
+        /** @brief Validate if the document has a grammar */
+        validate_auto,
+        /** @brief Validate and throw errors */
+        validate_always
+    };
+
+    parse_options()
+    : _validation(validate_auto)
+    , _namespaces(false)
+    , _schema(false)
+    , _schema_full_checking(false)
+    , _cache_grammar(false)
+    , _grammars(0)
+    , _projection(0) { }
+
+    /** @brief Options of a load validated against XML schema<br>
+     * @param grammars cache of preloaded grammars, may be NULL
+     *  */
+    static parse_options validated(grammar_cache* grammars = 0) {
+        parse_options options;
+        options._validation = validate_always;
+        options._namespaces = true;
+        options._schema = true;
+        options._grammars = grammars;
+        return options;
+    }
+
+    /** @brief Validation scheme */
+    validation_t _validation;
+    /** @brief Namespaces processing, schema processing turns it on */
+    bool _namespaces;
+    /** @brief XML schema processing */
+    bool _schema;
+    /** @brief Full schema constraint checking, it is expensive */
+    bool _schema_full_checking;
+    /** @brief Put grammars met during parse to the cache.<br>
+     * Unlocked cache must not be shared between threads then. */
+    bool _cache_grammar;
+    /** @brief Cache of grammars used in parse, NULL for no cache */
+    grammar_cache* _grammars;
+    /** @brief Subtrees kept by the parse, NULL to keep the whole document */
+    const projection* _projection;
+};
+
+/** @brief Error handler which keeps the first parse error.<br>
+ * Xerces reports validation errors to the handler only, so
+ * validated loads use it to throw them after parse.
+ */
+class parse_errors : public ErrorHandler {
+public:
+    parse_errors()
+    : _errors(0) { }
+
+    virtual void warning(const SAXParseException&) { }
+
+    virtual void error(const SAXParseException& ex) {
+        record(ex);
+    }
+
+    virtual void fatalError(const SAXParseException& ex) {
+        record(ex);
+    }
+
+    virtual void resetErrors() {
+        _errors = 0;
+        _message.clear();
+    }
+
+    /** @return number of errors */
+    size_t errors() const {
+        return _errors;
+    }
+
+    /** @return first error with its line number */
+    const std::string& message() const {
+        return _message;
+    }
+
+    /** @brief Throw the first error as <code>std::runtime_error</code> */
+    void check() const;
+
+private:
+
+    void record(const SAXParseException& ex);
+
+    size_t _errors;
+    std::string _message;
+};
+
+/** @brief This class implements a thread-safe pool of configured
+ * XercesDOMParser objects.<br>
+ * Parser construction and configuration is much more expensive than
+ * a parse of a small document, so several <code>dom_document</code>
+ * instances may share the pool and reuse parsers between loads.
+ * Parsed documents are adopted by the caller instead of cloning.
+ * The pool must be destroyed before <code>XMLPlatformUtils::Terminate()</code>.
+ * @code
+ * xerces::dom_parser_pool pool;
+ * xerces::dom_document settings("settings.xml", pool);
+ * xerces::dom_document colors("colors.xml", pool);
+ * @endcode
+ */
+class dom_parser_pool : boost::noncopyable {
+public:
+
+    /** @brief RAII-wrapper under parser checked out from the pool.<br>
+     * The parser is returned back to the pool on destruction.
+     * @code
+     * dom_parser_pool::lease parser(pool);
+     * parser->parse(filename);
+     * DOMDocument* doc = parser.adopt_document();
+     * @endcode
+     */
+    class lease : boost::noncopyable {
+    public:
+        explicit lease(dom_parser_pool& pool)
+        : _pool(pool)
+        , _parser(pool.checkout()) { }
+
+        ~lease() {
+            _pool.checkin(_parser);
+        }
+
+        XercesDOMParser* get() {
+            return _parser;
+        }
+
+        XercesDOMParser* operator->() {
+            return _parser;
+        }
+
+        
+        /** @brief Take ownership of the parsed document.<br>
+         * It must be released with <code>DOMDocument::release() method</code>
+         *  */
+        DOMDocument* adopt_document() {
+            return _parser->adoptDocument();
+        }
+
+    private:
+        dom_parser_pool& _pool;
+        XercesDOMParser* _parser;
+    };
+
+    /** @brief Default number of idle parsers kept in the pool */
+    static const size_t default_max_idle = 8;
+
+    
+    /** @brief Pool constructor<br>
+     * @param max_idle maximum number of idle parsers kept for reuse,
+     * parsers returned over the limit are deleted
+     * @param grammars cache of grammars for pooled parsers, it must
+     * outlive the pool
+     *  */
+    explicit dom_parser_pool(size_t max_idle = default_max_idle
+            , grammar_cache* grammars = 0);
+
+    ~dom_parser_pool();
+
+    
+    /** @brief Get configured parser from the pool or create a new one.<br>
+     * It must be returned with <code>checkin()</code>, use
+     * <code>lease</code> wrapper instead of direct call.
+     *  */
+    XercesDOMParser* checkout();
+
+    
+    /** @brief Return parser to the pool.<br>
+     * Documents which were not adopted are released.
+     *  */
+    void checkin(XercesDOMParser* parser);
+
+    
+    /** @brief Apply loading settings to the parser.<br>
+     * The parser must be created with the grammar pool of
+     * <code>options._grammars</code>, if any.
+     *  */
+    static void configure(XercesDOMParser& parser
+            , const parse_options& options = parse_options());
+
+    
+    /** @return cache of grammars used by pooled parsers, NULL if none */
+    grammar_cache* grammars() const {
+        return _grammars;
+    }
+
+    
+    /** @return number of idle parsers */
+    size_t idle() const;
+
+    
+    /** @return number of parsers created by the pool */
+    size_t created() const;
+
+private:
+
+    /** @brief Protects pool state */
+    mutable boost::mutex _mutex;
+
+    /** @brief Parsers ready for checkout */
+    std::vector<XercesDOMParser*> _idle;
+
+    size_t _max_idle;
+    size_t _created;
+
+    /** @brief Grammars of pooled parsers */
+    grammar_cache* const _grammars;
+};
+
+}
+
+#endif	/* DOM_PARSER_POOL_H */
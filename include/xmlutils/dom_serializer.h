@@ -0,0 +1,132 @@
+/* 
+ * File:   dom_serializer.h
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 15:30
+ */
+
+#ifndef DOM_SERIALIZER_H
+#define	DOM_SERIALIZER_H
+
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/dom/DOMWriter.hpp>
+#include <xercesc/framework/XMLFormatter.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief This class implements a reusable DOM serializer.<br>
+ * One DOMWriter is created per serializer and kept for all writes.
+ * Output goes to a memory buffer, a file descriptor (e.g. socket) or
+ * a file, optionally replaced atomically through a temporary file.
+ * File and descriptor output is collected in a buffer of the given
+ * size, so small writes of the formatter don't turn into system calls.
+ * @code
+ * xerces::dom_serializer serializer(xerces::dom_serializer::compact);
+ * std::string message;
+ * serializer.write(*doc, message);
+ * serializer.write(*doc, socket_fd);
+ * serializer.write_file(*doc, "settings.xml", true);
+ * @endcode
+ */
+class dom_serializer : boost::noncopyable {
+public:
+
+    /** @brief Output format */
+    enum format_t {
+        /** @brief No indentation and line breaks */
+        compact,
+        /** @brief Indented, human readable */
+        pretty
+    };
+
+    /** @brief Default output buffer size in bytes */
+    static const size_t default_buffer_size = 64 * 1024;
+
+
+    /** @brief Serializer constructor<br>
+     * @param format compact or pretty output
+     * @param buffer_size file and descriptor output buffer size in bytes
+     *  */
+    explicit dom_serializer(format_t format = pretty
+            , size_t buffer_size = default_buffer_size);
+
+    ~dom_serializer();
+
+
+    /** @brief Change output format of following writes */
+    void set_format(format_t format);
+
+    /** @brief Current output format */
+    format_t format() const {
+        return _format;
+    }
+
+    /** @brief Change output buffer size of following writes */
+    void set_buffer_size(size_t buffer_size);
+
+    /** @brief Current output buffer size in bytes */
+    size_t buffer_size() const {
+        return _buffer_size;
+    }
+
+
+    /** @brief Append serialized node to memory buffer<br>
+     * @param node document or any node of it
+     * @param buffer output, it is appended, not replaced
+     * @return number of bytes written
+     *  */
+    size_t write(const DOMNode& node, std::string& buffer);
+
+    /** @brief Write serialized node to file descriptor<br>
+     * The descriptor is not closed. Partial and interrupted writes
+     * are continued, other errors are thrown.
+     * @param node document or any node of it
+     * @param fd open file descriptor or socket
+     * @return number of bytes written
+     *  */
+    size_t write(const DOMNode& node, int fd);
+
+    /** @brief Write serialized node to file<br>
+     * With <code>atomic</code> flag the node is written to a temporary
+     * file in the same directory, which is synced and renamed over
+     * the target, so readers never see a partial file.
+     * @param node document or any node of it
+     * @param filename output file name
+     * @param atomic replace file through temporary file and rename
+     * @return number of bytes written
+     *  */
+    size_t write_file(const DOMNode& node, const char* filename
+            , bool atomic = false);
+
+    /** @brief Write prepared bytes to file like serialized node<br>
+     * @param data file content
+     * @param filename output file name
+     * @param atomic replace file through temporary file and rename
+     * @return number of bytes written
+     *  */
+    static size_t write_file(const std::string& data, const char* filename
+            , bool atomic = false);
+
+private:
+
+    /** @brief Serialize node to the target, throw on failure */
+    void serialize(const DOMNode& node, XMLFormatTarget& target);
+
+    /** @brief Reused writer */
+    DOMWriter* _writer;
+
+    /** @brief Output format */
+    format_t _format;
+
+    /** @brief File and descriptor output buffer size */
+    size_t _buffer_size;
+};
+
+}
+
+#endif	/* DOM_SERIALIZER_H */
+
@@ -0,0 +1,32 @@
+/* 
+ * File:   error_message.h
+ * Author: ycherkasov
+ *
+ * Created on 26 Октябрь 2026 г., 10:20
+ */
+
+#ifndef ERROR_MESSAGE_H
+#define	ERROR_MESSAGE_H
+
+#include <string>
+
+namespace xerces {
+
+/** @brief Message of the exception being handled.<br>
+ * Standard, Xerces (<code>XMLException</code>, <code>SAXException</code>)
+ * and Xalan (<code>XSLException</code>) exceptions give their message,
+ * others give a generic one. Must be called in a catch block only.
+ * @code
+ * try {
+ *     evaluator.open(filename);
+ * }
+ * catch (...) {
+ *     error = xerces::current_error_message();
+ * }
+ * @endcode
+ */
+std::string current_error_message();
+
+}
+
+#endif	/* ERROR_MESSAGE_H */
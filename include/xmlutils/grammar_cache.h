@@ -0,0 +1,95 @@
+/* 
+ * File:   grammar_cache.h
+ * Author: ycherkasov
+ *
+ * Created on 20 Октябрь 2026 г., 14:30
+ */
+
+#ifndef GRAMMAR_CACHE_H
+#define	GRAMMAR_CACHE_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <xercesc/framework/XMLGrammarPool.hpp>
+#include <xercesc/internal/XMLGrammarPoolImpl.hpp>
+#include <xercesc/validators/common/Grammar.hpp>
+
+#include "xmlutils/platform.h"
+#include "xmlutils/dom_parser_pool.h"
+
+namespace xerces {
+
+/** @brief This class implements a shared cache of compiled grammars.<br>
+ * Without the cache every validated parse reads and compiles its DTD
+ * or XML schema again. The application creates one cache at startup,
+ * preloads its schemas and locks it; then validated loads of all
+ * documents take compiled grammars from it.
+ * The cache is read-only and may be shared between threads after
+ * <code>lock()</code>. It must outlive parsers and pools which use it.
+ * @code
+ * xerces::grammar_cache grammars;
+ * grammars.preload_schema("settings.xsd");
+ * grammars.lock();
+ * xerces::dom_document domDocument("settings.xml"
+ *     , xerces::parse_options::validated(&grammars));
+ * @endcode
+ */
+class grammar_cache : boost::noncopyable {
+public:
+
+    grammar_cache();
+
+    ~grammar_cache();
+
+
+    /** @brief Compile XML schema and put it to the cache<br>
+     * @param filename XSD file name
+     *  */
+    void preload_schema(const char* filename);
+
+    /** @brief Compile DTD and put it to the cache<br>
+     * @param filename DTD file name
+     *  */
+    void preload_dtd(const char* filename);
+
+
+    /** @brief Make the cache read-only.<br>
+     * Preload is not allowed after lock, grammars met during parse
+     * are not cached.
+     *  */
+    void lock();
+
+    /** @return true if the cache is locked */
+    bool locked() const;
+
+    /** @return number of preloaded grammars */
+    size_t preloaded() const;
+
+
+    /** @return Xerces grammar pool for parser construction */
+    XMLGrammarPool* pool() const {
+        return _pool.get();
+    }
+
+private:
+
+    /** @brief Compile grammar and put it to the cache */
+    void preload(const char* filename, Grammar::GrammarType type);
+
+    /** @brief Xerces is held while grammars are alive */
+    platform _platform;
+
+    /** @brief Compiled grammars */
+    boost::scoped_ptr<XMLGrammarPoolImpl> _pool;
+
+    /** @brief Serializes preload and lock */
+    mutable boost::mutex _mutex;
+
+    bool _locked;
+    size_t _preloaded;
+};
+
+}
+
+#endif	/* GRAMMAR_CACHE_H */
@@ -0,0 +1,75 @@
+/* 
+ * File:   mapped_file.h
+ * Author: ycherkasov
+ *
+ * Created on 17 Октябрь 2026 г., 17:10
+ */
+
+#ifndef MAPPED_FILE_H
+#define	MAPPED_FILE_H
+
+#include <climits>
+#include <cstddef>
+#include <stdexcept>
+#include <boost/noncopyable.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <xercesc/util/XercesDefs.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief This class implements RAII-wrapper under read-only memory
+ * mapped file.<br>
+ * The mapped region can be passed to <code>dom_document</code> or
+ * <code>xpath</code> as a byte span, so the file is parsed without
+ * read-and-copy into an intermediate buffer.
+ * Mapping must be alive while the document is loading.
+ * @code
+ * xerces::mapped_file file("settings.xml");
+ * xerces::dom_document domDocument(file.data(), file.size());
+ * @endcode
+ */
+class mapped_file : boost::noncopyable {
+public:
+
+    /** @brief Map whole file into memory.<br>
+     * Throws <code>boost::interprocess::interprocess_exception</code>
+     * if the file can not be mapped (e.g. it does not exist or empty).
+     * @param filename file name
+     *  */
+    explicit mapped_file(const char* filename)
+    : _mapping(filename, boost::interprocess::read_only)
+    , _region(_mapping, boost::interprocess::read_only) { }
+
+    /** @brief Mapped file content */
+    const XMLByte* data() const {
+	return static_cast<const XMLByte*>(_region.get_address());
+    }
+
+    /** @brief Mapped file size in bytes */
+    std::size_t size() const {
+	return _region.get_size();
+    }
+
+private:
+    boost::interprocess::file_mapping _mapping;
+    boost::interprocess::mapped_region _region;
+};
+
+/** @brief Size of byte span for Xerces input source<br>
+ * Xerces buffers are limited by 32-bit size, larger spans throw
+ * <code>std::length_error</code> instead of being truncated.
+ * @param size span size in bytes
+ * @return size accepted by <code>MemBufInputSource</code>
+ *  */
+inline unsigned int buffer_size(std::size_t size) {
+    if (size > UINT_MAX)
+	throw std::length_error("XML buffer is too large to parse");
+    return static_cast<unsigned int>(size);
+}
+
+}
+
+#endif	/* MAPPED_FILE_H */
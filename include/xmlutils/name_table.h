@@ -0,0 +1,83 @@
+/* 
+ * File:   name_table.h
+ * Author: ycherkasov
+ *
+ * Created on 19 Октябрь 2026 г., 10:40
+ */
+
+#ifndef NAME_TABLE_H
+#define	NAME_TABLE_H
+
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+#include <xercesc/util/XercesDefs.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief This class implements intern table of element and attribute
+ * names.<br>
+ * Documents with a fixed schema use the same few names for thousands of
+ * nodes. The table transcodes each distinct name once and gives out
+ * <code>name</code> handles to pooled wide-char strings, which can be
+ * passed to <code>dom_document</code> builder methods instead of
+ * narrow strings.
+ * @code
+ * xerces::dom_document domDocument;
+ * xerces::name_table::name srv = domDocument.intern("server_settings");
+ * for(size_t i = 0; i < addresses.size(); ++i)
+ *     domDocument.create_node(srv, addresses[i].c_str());
+ * @endcode
+ */
+class name_table : boost::noncopyable {
+public:
+
+    /** @brief Handle of interned name.<br>
+     * It is valid while the table it was taken from exists.
+     */
+    class name {
+    public:
+	name() : _name(0) { }
+
+	/** @brief Get pooled wide-char name */
+	const XMLCh* get() const {
+	    return _name;
+	}
+
+    private:
+	friend class name_table;
+	explicit name(const XMLCh* n) : _name(n) { }
+
+	const XMLCh* _name;
+    };
+
+    name_table() { }
+
+    ~name_table();
+
+    
+    /** @brief Get handle of the name, transcode it on first use<br>
+     * @param n element or attribute name
+     * @param utf8 true if name is UTF-8, local code page otherwise
+     * @return name handle
+     *  */
+    name intern(const char* n, bool utf8 = false);
+
+    
+    /** @return number of distinct names, counted per encoding */
+    size_t size() const {
+	return _names.size();
+    }
+
+private:
+    typedef boost::unordered_map<std::string, XMLCh*> table_t;
+
+    /** @brief Encoding tag and narrow name to pooled wide-char name */
+    table_t _names;
+};
+
+}
+
+#endif	/* NAME_TABLE_H */
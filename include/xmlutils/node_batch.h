@@ -0,0 +1,130 @@
+/* 
+ * File:   node_batch.h
+ * Author: ycherkasov
+ *
+ * Created on 19 Октябрь 2026 г., 14:20
+ */
+
+#ifndef NODE_BATCH_H
+#define	NODE_BATCH_H
+
+#include <string>
+#include <vector>
+#include <boost/unordered_map.hpp>
+
+namespace xerces {
+
+class dom_document;
+
+/** @brief This class implements a list of element records for bulk
+ * document building.<br>
+ * Every record is an element name, an optional text value and a list
+ * of attributes. Strings are copied into one flat buffer, and distinct
+ * names are collected once per batch, so filling the batch takes a few
+ * allocations only. The batch is appended with
+ * <code>dom_document::append_nodes()</code> and may be reused after
+ * <code>clear()</code>.
+ * @code
+ * xerces::node_batch batch;
+ * batch.reserve(addresses.size(), addresses.size());
+ * for(size_t i = 0; i < addresses.size(); ++i)
+ *     batch.add("server_settings", addresses[i].c_str()).attribute("port", "8080");
+ * domDocument.append_nodes(batch);
+ * @endcode
+ */
+class node_batch {
+public:
+
+    node_batch() { }
+
+
+    /** @brief Reserve space ahead of time<br>
+     * @param nodes expected number of elements
+     * @param attributes expected number of attributes of all elements
+     * @param chars expected size of all values in bytes
+     *  */
+    void reserve(size_t nodes, size_t attributes = 0, size_t chars = 0);
+
+
+    /** @brief Add element record<br>
+     * @param name element name
+     * @param value text value, no text node if NULL
+     * @return the batch, to add attributes of this element
+     *  */
+    node_batch& add(const char* name, const char* value = 0);
+
+
+    /** @brief Add attribute to the last added element<br>
+     * Throws <code>std::logic_error</code> if no element added
+     * @param name attribute name
+     * @param value attribute value
+     * @return the batch
+     *  */
+    node_batch& attribute(const char* name, const char* value);
+
+
+    /** @brief Number of element records */
+    size_t size() const {
+        return _nodes.size();
+    }
+
+    /** @brief True if no records added */
+    bool empty() const {
+        return _nodes.empty();
+    }
+
+    /** @brief Remove all records, keep reserved memory */
+    void clear();
+
+private:
+    friend class dom_document;
+
+    /** @brief No value offset */
+    static const size_t npos = static_cast<size_t>(-1);
+
+    /** @brief Element record, attributes end index in the
+     * attribute list, they start where the previous element's end */
+    struct node_t {
+        size_t _name;
+        size_t _value;
+        size_t _attributes_end;
+    };
+
+    /** @brief Attribute record */
+    struct attribute_t {
+        size_t _name;
+        size_t _value;
+    };
+
+    /** @brief Index of name in the distinct names list, add if new */
+    size_t name_index(const char* name);
+
+    /** @brief Copy value to chars buffer
+     * @return value offset, npos for NULL */
+    size_t store(const char* value);
+
+    /** @brief Value by offset */
+    const char* value(size_t offset) const {
+        return &_chars[offset];
+    }
+
+    /** @brief Element records */
+    std::vector<node_t> _nodes;
+
+    /** @brief Attributes of all elements, in order */
+    std::vector<attribute_t> _attributes;
+
+    /** @brief Zero-terminated values */
+    std::vector<char> _chars;
+
+    /** @brief Distinct element and attribute names */
+    std::vector<std::string> _names;
+
+    /** @brief Name to distinct names list index */
+    boost::unordered_map<std::string, size_t> _name_index;
+};
+
+}
+
+#endif	/* NODE_BATCH_H */
+
@@ -0,0 +1,146 @@
+/* 
+ * File:   node_index.h
+ * Author: ycherkasov
+ *
+ * Created on 20 Октябрь 2026 г., 17:10
+ */
+
+#ifndef NODE_INDEX_H
+#define	NODE_INDEX_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <xercesc/dom/DOM.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief This class implements hash indexes of document elements.<br>
+ * Element name is mapped to the list of elements with this name, and
+ * (attribute name, value) pair is mapped to the list of elements
+ * with this attribute value. Lookups are hash lookups, they neither
+ * scan the document nor use Xalan.
+ * Keys are in the local code page, like names passed to
+ * <code>dom_document</code> builder methods.
+ * Elements are listed in load order, then in the order they were added.
+ * The index is owned by <code>dom_document</code>, which updates it on
+ * every change made by its methods. Removal takes constant time: removed
+ * elements are left as holes, which are compacted by the next lookup
+ * of the list, so lookups must not run concurrently with each other.
+ */
+class node_index : boost::noncopyable {
+public:
+
+    /** @brief List of indexed elements */
+    typedef std::vector<DOMElement*> element_list_t;
+
+
+    /** @brief Index constructor<br>
+     * @param attributes names of indexed attributes, all attributes
+     * are indexed if empty
+     *  */
+    explicit node_index(const std::vector<std::string>& attributes);
+
+
+    /** @brief Rebuild the index from all elements in one pass<br>
+     * @param root document element
+     *  */
+    void build(DOMElement* root);
+
+    /** @brief Forget all elements */
+    void clear();
+
+
+    /** @brief Index element with its attributes, but not children */
+    void add(DOMElement* element);
+
+    /** @brief Remove all elements of the subtree */
+    void remove_subtree(DOMElement* root);
+
+    /** @brief Index current value of element attribute */
+    void add_attribute(DOMElement* element, const XMLCh* name);
+
+    /** @brief Remove current value of element attribute from index */
+    void remove_attribute(DOMElement* element, const XMLCh* name);
+
+
+    /** @brief Elements with the name<br>
+     * @return list of elements, empty if there are none; it is valid
+     * until the next change of the index
+     *  */
+    const element_list_t& by_name(const std::string& name) const;
+
+    /** @brief Elements with the attribute value<br>
+     * @return list of elements, empty if there are none or attribute
+     * is not indexed; it is valid until the next change of the index
+     *  */
+    const element_list_t& by_attribute(const std::string& name
+            , const std::string& value) const;
+
+
+    /** @return true if the attribute is indexed */
+    bool indexed(const std::string& attribute) const {
+        return _attributes.empty() || _attributes.count(attribute) != 0;
+    }
+
+private:
+
+    typedef std::pair<std::string, std::string> attribute_key_t;
+
+    /** @brief Elements of one key with their positions.<br>
+     * Removed elements are NULL until the list is compacted */
+    class list_t {
+    public:
+        list_t() : _removed(0) { }
+
+        void push_back(DOMElement* element);
+
+        /** @brief Remove element, return true if the list is empty */
+        bool erase(DOMElement* element);
+
+        /** @brief Elements without holes */
+        const element_list_t& elements() const;
+
+    private:
+        mutable element_list_t _elements;
+        mutable boost::unordered_map<DOMElement*, size_t> _positions;
+        mutable size_t _removed;
+    };
+
+    /** @brief Index attribute node of element */
+    void add_attribute(DOMElement* element, const DOMAttr* attr);
+
+    /** @brief Remove attribute node of element from index */
+    void remove_attribute(DOMElement* element, const DOMAttr* attr);
+
+    /** @brief Remove element and its attributes, but not children */
+    void remove(DOMElement* element);
+
+    /** @brief Narrow name, transcoded once per pooled document name */
+    const std::string& narrow_name(const XMLCh* name);
+
+    /** @brief Names of indexed attributes, empty for all */
+    const boost::unordered_set<std::string> _attributes;
+
+    /** @brief Element name to elements */
+    boost::unordered_map<std::string, list_t> _by_name;
+
+    /** @brief Attribute name and value to elements */
+    boost::unordered_map<attribute_key_t, list_t> _by_attribute;
+
+    /** @brief Names are pooled by the document, so they are
+     * transcoded once per distinct pointer */
+    boost::unordered_map<const XMLCh*, std::string> _narrow_names;
+
+    /** @brief Result of failed lookups */
+    static const element_list_t _empty;
+};
+
+}
+
+#endif	/* NODE_INDEX_H */
@@ -0,0 +1,94 @@
+/* 
+ * File:   path_index.h
+ * Author: ycherkasov
+ *
+ * Created on 21 Октябрь 2026 г., 10:20
+ */
+
+#ifndef PATH_INDEX_H
+#define	PATH_INDEX_H
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+#include <xalanc/XalanDOM/XalanDocument.hpp>
+#include <xalanc/XalanDOM/XalanNode.hpp>
+
+XALAN_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief This class implements index of absolute node paths.<br>
+ * Every distinct absolute path of the document is mapped to its nodes
+ * in document order: elements (<code>/root/server_settings</code>),
+ * attributes (<code>/root/color_settings/@line_color</code>) and text
+ * (<code>/root/server_settings/text()</code>). Queries of this shape are
+ * answered by a single hash probe, without compilation and tree walk.
+ * The index takes memory for every node of the document, see
+ * <code>memory()</code>; <code>xpath</code> builds it on request only.
+ * Prefixed names are not indexed.
+ */
+class path_index : boost::noncopyable {
+public:
+
+    /** @brief Nodes of one path in document order */
+    typedef std::vector<XalanNode*> node_list_t;
+
+    path_index();
+
+
+    /** @brief Index all nodes of the document in one pass */
+    void build(const XalanDocument* document);
+
+    /** @brief Forget all nodes */
+    void clear();
+
+
+    /** @brief Check if XPath expression can be answered by the index<br>
+     * It must be an absolute path of element names, optionally ended
+     * with an attribute or <code>text()</code> step, without predicates,
+     * wildcards, axes and prefixes, i.e. a
+     * <code>simple_path::child_path()</code>.
+     * @param expr XPath expression
+     * @return true if expression is an indexed path
+     *  */
+    static bool indexable(const char* expr);
+
+    /** @brief Nodes of the path<br>
+     * @param path indexable XPath expression
+     * @return nodes in document order, NULL if the document has none
+     *  */
+    const node_list_t* find(const std::string& path) const;
+
+
+    /** @return number of distinct paths */
+    size_t paths() const {
+        return _paths.size();
+    }
+
+    /** @return number of indexed nodes */
+    size_t nodes() const {
+        return _nodes;
+    }
+
+    /** @return approximate memory taken by the index in bytes */
+    size_t memory() const;
+
+private:
+
+    typedef boost::unordered_map<std::string, node_list_t> paths_t;
+
+    /** @brief Add node to path */
+    void add(const std::string& path, XalanNode* node);
+
+    /** @brief Path to nodes */
+    paths_t _paths;
+
+    /** @brief Number of indexed nodes */
+    size_t _nodes;
+};
+
+}
+
+#endif	/* PATH_INDEX_H */
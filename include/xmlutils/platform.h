@@ -0,0 +1,83 @@
+/* 
+ * File:   platform.h
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 13:10
+ */
+
+#ifndef PLATFORM_H
+#define	PLATFORM_H
+
+#include <cstddef>
+#include <boost/noncopyable.hpp>
+
+namespace xerces {
+
+/** @brief This class implements a thread-safe reference-counted guard
+ * of Xerces and Xalan platform initialization.<br>
+ * A component is initialized by the first guard constructed and
+ * terminated when the last guard is destroyed. Nested guards and guards
+ * in several threads only change the reference counter, so keep one
+ * long-lived guard (e.g. in <code>main()</code>) to initialize the
+ * platform once per process.
+ * Do not mix guards with direct <code>XalanTransformer::initialize()</code>
+ * calls, it is not reference-counted.
+ * @code
+ * int main() {
+ *     xerces::platform guard(xerces::platform::transformer_component);
+ *     // every xpath evaluator holds its own guard, it is cheap now
+ *     xerces::xpath evaluator("settings.xml");
+ * }
+ * @endcode
+ */
+class platform : boost::noncopyable {
+public:
+
+    /** @brief Initialized part of the platform */
+    enum component_t {
+        /** @brief XMLPlatformUtils */
+        xerces_component,
+        /** @brief XPathInit and XalanSourceTreeInit, requires Xerces */
+        xpath_component,
+        /** @brief XalanTransformer, requires Xerces */
+        transformer_component,
+        component_count
+    };
+
+
+    /** @brief Acquire the component, initialize it on first use<br>
+     * Initialization errors are thrown as <code>std::runtime_error</code>
+     * @param component component to initialize
+     *  */
+    explicit platform(component_t component = xpath_component);
+
+    /** @brief Release the component, terminate it by the last guard */
+    ~platform();
+
+
+    /** @brief Acquire the component without guard object<br>
+     * Every call must be paired with <code>release()</code>
+     *  */
+    static void acquire(component_t component);
+
+    /** @brief Release the component acquired with <code>acquire()</code> */
+    static void release(component_t component);
+
+
+    /** @brief Number of guards holding the component */
+    static size_t references(component_t component);
+
+    /** @brief How many times the component has been initialized
+     * since process start */
+    static size_t initializations(component_t component);
+
+private:
+
+    /** @brief Held component */
+    const component_t _component;
+};
+
+}
+
+#endif	/* PLATFORM_H */
+
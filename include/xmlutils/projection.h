@@ -0,0 +1,304 @@
+/* 
+ * File:   projection.h
+ * Author: ycherkasov
+ *
+ * Created on 23 Октябрь 2026 г., 15:10
+ */
+
+#ifndef PROJECTION_H
+#define	PROJECTION_H
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax2/ContentHandler.hpp>
+#include <xercesc/sax2/LexicalHandler.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief This class implements set of path patterns kept by load-time
+ * projection.<br>
+ * Only subtrees matched by the patterns and the elements on the way to
+ * them become nodes, other subtrees are dropped by the parser as soon
+ * as their start tag is seen. Elements on the way keep their attributes
+ * but not their text. The root element is always kept.
+ *
+ * Pattern is a location path of element names or <code>*</code> with
+ * child (<code>/</code>) and descendant (<code>//</code>) steps.
+ * Predicates and final attribute or <code>text()</code> steps are
+ * accepted and widened to the whole element, so usual queries may
+ * be given as patterns. Prefixes are ignored, names are matched by
+ * local part. Elements on the way with nothing kept inside them,
+ * e.g. those looked through by a <code>//</code> step, are dropped
+ * at their end.
+ * @code
+ * xerces::projection servers;
+ * servers.add("/root/server_settings");
+ * servers.add("/root/color_settings/@line_color");
+ * xerces::parse_options options;
+ * options._projection = &servers;
+ * xerces::dom_document settings("settings.xml", options);
+ * @endcode
+ */
+class projection {
+public:
+
+    /** @brief Wide-char string used for compiled names */
+    typedef std::basic_string<XMLCh> xstring_t;
+
+    /** @brief What to do with the element just started */
+    enum decision_t {
+        /** @brief Drop the element with its subtree */
+        skip_subtree,
+        /** @brief Keep the element and attributes, children are checked */
+        keep_element,
+        /** @brief Keep the whole subtree */
+        keep_subtree
+    };
+
+    /** @brief Location step of the pattern */
+    struct step_t {
+        /** @brief Descendant axis if true, child axis otherwise */
+        bool _descendant;
+        /** @brief Element local name, empty for wildcard */
+        xstring_t _name;
+    };
+
+    /** @brief Compiled pattern */
+    typedef std::vector<step_t> pattern_t;
+
+
+    /** @brief Keeps matching state of open elements during one parse */
+    class matcher : boost::noncopyable {
+    public:
+        explicit matcher(const projection& patterns);
+
+        /** @brief Element start<br>
+         * Kept elements must be closed with <code>leave()</code>,
+         * skipped ones must not.
+         * @param name element local name
+         * @return decision for the element
+         *  */
+        decision_t enter(const XMLCh* name);
+
+        /** @brief Kept element end<br>
+         * @return false if the element was kept on the way only
+         * and nothing inside it is kept, so it must be dropped
+         *  */
+        bool leave();
+
+        /** @brief Check if text of the innermost open element is kept */
+        bool text_kept() const;
+
+        /** @brief Forget open elements before the next parse */
+        void reset() {
+            _open.clear();
+        }
+
+        /** @brief Check if no element is open */
+        bool top_level() const {
+            return _open.empty();
+        }
+
+    private:
+
+        /** @brief Pattern and its next step */
+        typedef std::pair<size_t, size_t> position_t;
+
+        /** @brief State of open element */
+        struct open_t {
+            bool _inside;
+            /** @brief Something inside the element is kept */
+            bool _used;
+            std::vector<position_t> _positions;
+        };
+
+        const projection& _patterns;
+        std::vector<open_t> _open;
+    };
+
+
+    projection();
+
+    /** @brief Construct projection of patterns<br>
+     * @param patterns path patterns
+     *  */
+    explicit projection(const std::vector<std::string>& patterns);
+
+
+    /** @brief Add pattern<br>
+     * Throws <code>std::runtime_error</code> if it is not a location path
+     * of names (optionally with <code>child::</code> axis) and
+     * <code>*</code> steps.
+     * @param pattern path pattern, e.g. <code>/root/server_settings</code>
+     *  */
+    void add(const char* pattern);
+
+    /** @return compiled patterns */
+    const std::vector<pattern_t>& patterns() const {
+        return _patterns;
+    }
+
+    /** @brief Check if there are no patterns, nothing is projected then */
+    bool empty() const {
+        return _patterns.empty();
+    }
+
+private:
+    std::vector<pattern_t> _patterns;
+};
+
+
+/** @brief DOM parser which drops subtrees out of projection.<br>
+ * Scanner events of skipped subtrees are not passed to the DOM builder,
+ * so they never take node memory.
+ */
+class projection_dom_parser : public XercesDOMParser {
+public:
+
+    /** @brief Construct parser<br>
+     * @param patterns projection, must outlive the parser
+     * @param manager memory manager of parsed documents
+     * @param grammars pool of cached grammars, may be NULL
+     *  */
+    projection_dom_parser(const projection& patterns
+            , MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager
+            , XMLGrammarPool* const grammars = 0);
+
+    virtual void startElement(const XMLElementDecl& elemDecl
+            , const unsigned int urlId
+            , const XMLCh* const elemPrefix
+            , const RefVectorOf<XMLAttr>& attrList
+            , const unsigned int attrCount
+            , const bool isEmpty
+            , const bool isRoot);
+
+    virtual void endElement(const XMLElementDecl& elemDecl
+            , const unsigned int urlId
+            , const bool isRoot
+            , const XMLCh* const elemPrefix);
+
+    virtual void docCharacters(const XMLCh* const chars
+            , const unsigned int length
+            , const bool cdataSection);
+
+    virtual void ignorableWhitespace(const XMLCh* const chars
+            , const unsigned int length
+            , const bool cdataSection);
+
+    virtual void docComment(const XMLCh* const comment);
+
+    virtual void docPI(const XMLCh* const target, const XMLCh* const data);
+
+    virtual void startEntityReference(const XMLEntityDecl& entDecl);
+
+    virtual void endEntityReference(const XMLEntityDecl& entDecl);
+
+    virtual void resetDocument();
+
+private:
+
+    /** @brief Check if content at the current position is kept */
+    bool content_kept() const;
+
+    projection::matcher _matcher;
+
+    /** @brief Depth inside skipped subtree, 0 outside */
+    size_t _skipped;
+};
+
+
+/** @brief SAX2 handler which passes events of projected subtrees
+ * to the target handler.<br>
+ * Used to build Xalan source tree of the projection only.
+ */
+class projection_handler : public ContentHandler, public LexicalHandler
+        , boost::noncopyable {
+public:
+
+    /** @brief Construct filter<br>
+     * @param patterns projection, must outlive the handler
+     * @param content target content handler
+     * @param lexical target lexical handler, may be NULL
+     *  */
+    projection_handler(const projection& patterns, ContentHandler& content
+            , LexicalHandler* lexical = 0);
+
+    virtual void startElement(const XMLCh* const uri
+            , const XMLCh* const localname
+            , const XMLCh* const qname
+            , const Attributes& attrs);
+
+    virtual void endElement(const XMLCh* const uri
+            , const XMLCh* const localname
+            , const XMLCh* const qname);
+
+    virtual void characters(const XMLCh* const chars, const unsigned int length);
+
+    virtual void ignorableWhitespace(const XMLCh* const chars, const unsigned int length);
+
+    virtual void processingInstruction(const XMLCh* const target, const XMLCh* const data);
+
+    virtual void setDocumentLocator(const Locator* const locator);
+
+    virtual void startDocument();
+
+    virtual void endDocument();
+
+    virtual void startPrefixMapping(const XMLCh* const prefix, const XMLCh* const uri);
+
+    virtual void endPrefixMapping(const XMLCh* const prefix);
+
+    virtual void skippedEntity(const XMLCh* const name);
+
+    virtual void comment(const XMLCh* const chars, const unsigned int length);
+
+    virtual void startCDATA();
+
+    virtual void endCDATA();
+
+    virtual void startDTD(const XMLCh* const name
+            , const XMLCh* const publicId
+            , const XMLCh* const systemId);
+
+    virtual void endDTD();
+
+    virtual void startEntity(const XMLCh* const name);
+
+    virtual void endEntity(const XMLCh* const name);
+
+private:
+
+    /** @brief Element start held back until something inside is kept */
+    struct pending_t {
+        projection::xstring_t _uri;
+        projection::xstring_t _localname;
+        projection::xstring_t _qname;
+        /** @brief URI, local name, qualified name, type and value
+         * of each attribute */
+        std::vector<projection::xstring_t> _attrs;
+    };
+
+    /** @brief Check if content at the current position is kept */
+    bool content_kept() const;
+
+    /** @brief Pass held back element starts to the target handler */
+    void flush();
+
+    projection::matcher _matcher;
+    ContentHandler& _content;
+    LexicalHandler* const _lexical;
+
+    /** @brief Open elements on the way not passed yet, outermost first */
+    std::vector<pending_t> _pending;
+
+    /** @brief Depth inside skipped subtree, 0 outside */
+    size_t _skipped;
+};
+
+}
+
+#endif	/* PROJECTION_H */
@@ -0,0 +1,110 @@
+/* 
+ * File:   simple_path.h
+ * Author: ycherkasov
+ *
+ * Created on 21 Октябрь 2026 г., 14:45
+ */
+
+#ifndef SIMPLE_PATH_H
+#define	SIMPLE_PATH_H
+
+#include <vector>
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+#include <xalanc/XalanDOM/XalanNode.hpp>
+
+XALAN_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief This class implements evaluator of simple location paths.<br>
+ * Most queries are plain paths like <code>/root/server_settings</code>,
+ * <code>//server_settings/text()</code> or <code>@line_color</code>.
+ * They are evaluated by a direct walk of the tree, without Xalan
+ * compilation and execution context, and give the same nodes in the
+ * same document order. Supported subset:
+ * <ul>
+ * <li>absolute and relative paths, <code>/</code> alone</li>
+ * <li><code>/</code> (child) and <code>//</code> (descendant) steps</li>
+ * <li>element names without prefix and <code>*</code></li>
+ * <li>last step <code>@name</code> or <code>text()</code></li>
+ * </ul>
+ * Everything else is not parsed, and <code>xpath</code> evaluates it
+ * with Xalan.
+ * @code
+ * xerces::simple_path path;
+ * std::vector<XalanNode*> nodes;
+ * if (path.parse("//server_settings") && path.evaluate(root, nodes))
+ *     use(nodes);
+ * @endcode
+ */
+class simple_path {
+public:
+
+    /** @brief Selected nodes in document order */
+    typedef std::vector<XalanNode*> node_list_t;
+
+    simple_path();
+
+
+    /** @brief Parse expression<br>
+     * @param expr XPath expression
+     * @return false if expression is out of the supported subset
+     *  */
+    bool parse(const char* expr);
+
+    /** @brief Select nodes<br>
+     * Document order of <code>//</code> steps followed by other steps
+     * can't be kept by the walk if selected elements are nested,
+     * such expressions are left to Xalan.
+     * @param context context node
+     * @param result selected nodes, previous content is dropped
+     * @return false if expression must be evaluated by Xalan
+     *  */
+    bool evaluate(XalanNode* context, node_list_t& result) const;
+
+    /** @brief Check if parsed expression is a plain child path<br>
+     * Absolute path of element names, optionally ended with an
+     * attribute or <code>text()</code> step of an element, without
+     * <code>//</code> steps and wildcards.
+     *  */
+    bool child_path() const;
+
+private:
+
+    /** @brief Step axis */
+    enum axis_t {
+        child_axis,
+        descendant_axis
+    };
+
+    /** @brief Step node test */
+    enum test_t {
+        element_test,
+        any_element_test,
+        attribute_test,
+        text_test
+    };
+
+    /** @brief Location step */
+    struct step_t {
+        axis_t _axis;
+        test_t _test;
+        XalanDOMString _name;
+    };
+
+    /** @brief Add nodes selected by step from one node */
+    static void select(XalanNode* node, const step_t& step, node_list_t& result);
+
+    /** @brief Check if node passes step node test */
+    static bool matches(const XalanNode* node, const step_t& step);
+
+    /** @brief Check if any node is an ancestor of another one */
+    static bool nested(const node_list_t& nodes);
+
+    bool _absolute;
+    std::vector<step_t> _steps;
+};
+
+}
+
+#endif	/* SIMPLE_PATH_H */
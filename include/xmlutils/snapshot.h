@@ -0,0 +1,174 @@
+/* 
+ * File:   snapshot.h
+ * Author: ycherkasov
+ *
+ * Created on 22 Октябрь 2026 г., 11:30
+ */
+
+#ifndef SNAPSHOT_H
+#define	SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <xercesc/dom/DOM.hpp>
+
+#include "xmlutils/mapped_file.h"
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief This class implements read-only binary snapshot of a document.<br>
+ * The document is compiled once into a file of fixed-size node records,
+ * a table of child and attribute offsets and a table of UTF-8 strings.
+ * The file is memory mapped and queried in place, so opening costs
+ * page faults instead of parsing, and the pages are shared read-only
+ * by all processes mapping the same file.
+ *
+ * The header keeps format version, byte order, checksum of the tables,
+ * and size and modification time of the source XML file. Snapshot of
+ * other version or byte order, corrupted or older than its source
+ * is rejected on open.
+ *
+ * Elements, attributes, text and CDATA are kept; comments, processing
+ * instructions and namespace declarations are dropped.
+ * @code
+ * xerces::snapshot::compile("settings.xml", "settings.snap");
+ * // startup of every worker
+ * xerces::snapshot settings("settings.snap", "settings.xml");
+ * std::vector<std::string> servers = settings.evaluate("/root/server_settings/text()");
+ * @endcode
+ */
+class snapshot : boost::noncopyable {
+public:
+
+    /** @brief Node number, the document node is 0 */
+    typedef boost::uint32_t node_t;
+
+    /** @brief Selected nodes in document order */
+    typedef std::vector<node_t> node_list_t;
+
+    /** @brief Node kinds */
+    enum kind_t {
+        document_node,
+        element_node,
+        attribute_node,
+        text_node
+    };
+
+    /** @brief Format version, snapshots of other versions are rejected */
+    static const boost::uint32_t format_version = 2;
+
+
+    /** @brief Compile XML file into snapshot<br>
+     * The snapshot is written to a temporary file and renamed, so
+     * processes mapping the previous one are not affected.
+     * @param xml_filename source XML file
+     * @param filename snapshot file
+     * @return snapshot size in bytes
+     *  */
+    static size_t compile(const char* xml_filename, const char* filename);
+
+    /** @brief Compile parsed document into snapshot<br>
+     * @param document document to compile
+     * @param filename snapshot file
+     * @param source source XML file to check snapshot against, or NULL
+     * @return snapshot size in bytes
+     *  */
+    static size_t compile(const DOMDocument* document, const char* filename
+            , const char* source = 0);
+
+
+    /** @brief Map snapshot file<br>
+     * Throws <code>std::runtime_error</code> if the snapshot is of other
+     * format, corrupted or stale.
+     * @param filename snapshot file
+     * @param source source XML file, if set the snapshot must match
+     * its size and modification time
+     * @param verify check the checksum, it reads the whole file
+     *  */
+    explicit snapshot(const char* filename, const char* source = 0
+            , bool verify = true);
+
+    ~snapshot();
+
+
+    /** @return number of nodes including the document node */
+    size_t size() const;
+
+    /** @brief Node kind */
+    kind_t kind(node_t node) const;
+
+    /** @brief Element or attribute name, empty for other nodes */
+    const char* name(node_t node) const;
+
+    /** @brief Attribute value or text, empty for other nodes */
+    const char* value(node_t node) const;
+
+    /** @brief Parent node, element for attributes, 0 for the document */
+    node_t parent(node_t node) const;
+
+    /** @brief Number of child elements and text nodes */
+    size_t children(node_t node) const;
+
+    /** @brief Child node by its position */
+    node_t child(node_t node, size_t i) const;
+
+    /** @brief Number of element attributes */
+    size_t attributes(node_t node) const;
+
+    /** @brief Attribute node by its position */
+    node_t attribute(node_t node, size_t i) const;
+
+    /** @brief XPath string value: concatenated text of the subtree
+     * for the document and elements, value for other nodes */
+    std::string string_value(node_t node) const;
+
+
+    /** @brief Select nodes by absolute path<br>
+     * Path is element names or <code>*</code> separated by
+     * <code>/</code>, optionally ended with an attribute or
+     * <code>text()</code> step, e.g.
+     * <code>/root/color_settings/@line_color</code>.
+     * Throws <code>std::runtime_error</code> for other expressions.
+     * @param path absolute path
+     * @param result selected nodes, previous content is dropped
+     *  */
+    void select(const char* path, node_list_t& result) const;
+
+    /** @brief Select nodes by absolute path<br>
+     * @param path absolute path, see <code>select()</code>
+     * @return string values of selected nodes
+     *  */
+    std::vector<std::string> evaluate(const char* path) const;
+
+private:
+
+    struct header_t;
+    struct node_record_t;
+
+    /** @brief Node record, checked against the node count */
+    const node_record_t& record(node_t node) const;
+
+    /** @brief String from the string table */
+    const char* string_at(boost::uint32_t offset) const;
+
+    /** @brief Append text of the subtree */
+    void append_text(node_t node, std::string& text) const;
+
+    /** @brief Mapped snapshot */
+    boost::scoped_ptr<mapped_file> _file;
+
+    /** @brief Tables inside the mapped file */
+    const header_t* _header;
+    const node_record_t* _nodes;
+    const boost::uint32_t* _links;
+    const char* _strings;
+};
+
+}
+
+#endif	/* SNAPSHOT_H */
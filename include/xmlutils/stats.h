@@ -0,0 +1,130 @@
+/* 
+ * File:   stats.h
+ * Author: ycherkasov
+ *
+ * Created on 19 Октябрь 2026 г., 17:05
+ */
+
+#ifndef STATS_H
+#define	STATS_H
+
+#include <cstddef>
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace xerces {
+
+/** @brief Process-wide instrumentation of the library.<br>
+ * Phase timers measure time spent in parse, XPath compilation and
+ * execution, result transcoding and serialization with the monotonic
+ * clock. Counters count parsed documents, bytes read and written,
+ * returned nodes and transcode calls. Both are relaxed atomics, so they
+ * may be updated from any thread. Read them with <code>snapshot()</code>
+ * and export to a metrics system.
+ * The library is instrumented with <code>XMLUTILS_STATS_*</code> macros,
+ * which are compiled out without <code>XMLUTILS_STATS</code> definition;
+ * the snapshot is all zeros then.
+ * @code
+ * xerces::stats::snapshot_t s = xerces::stats::snapshot();
+ * for (size_t i = 0; i < xerces::stats::phase_count; ++i)
+ *     std::cout << xerces::stats::phase_name(i) << " " << s._phase_ns[i] << std::endl;
+ * @endcode
+ */
+namespace stats {
+
+/** @brief Timed phases */
+enum phase_t {
+    parse_phase,
+    compile_phase,
+    execute_phase,
+    transcode_phase,
+    serialize_phase,
+    phase_count
+};
+
+/** @brief Counters */
+enum counter_t {
+    documents_parsed,
+    bytes_read,
+    bytes_written,
+    nodes_returned,
+    transcode_calls,
+    counter_count
+};
+
+/** @brief Copy of all timers and counters */
+struct snapshot_t {
+    /** @brief Total time of every phase in nanoseconds */
+    boost::uint64_t _phase_ns[phase_count];
+    /** @brief Number of timed intervals of every phase */
+    boost::uint64_t _phase_calls[phase_count];
+    /** @brief Counter values */
+    boost::uint64_t _counters[counter_count];
+};
+
+/** @brief Read all timers and counters<br>
+ * Values are read one by one, they are not a consistent cut
+ * while other threads work. */
+snapshot_t snapshot();
+
+/** @brief Set all timers and counters to zero */
+void reset();
+
+/** @brief Phase name for export, e.g. "parse" */
+const char* phase_name(size_t phase);
+
+/** @brief Counter name for export, e.g. "documents_parsed" */
+const char* counter_name(size_t counter);
+
+/** @brief Increase counter */
+void add(counter_t counter, boost::uint64_t value = 1);
+
+/** @brief Add timed interval to phase */
+void add_time(phase_t phase, boost::uint64_t ns);
+
+/** @brief Monotonic clock in nanoseconds */
+boost::uint64_t now();
+
+/** @brief RAII phase timer, adds its lifetime to the phase */
+class phase_timer : boost::noncopyable {
+public:
+    explicit phase_timer(phase_t phase)
+    : _phase(phase)
+    , _start(now()) { }
+
+    ~phase_timer() {
+        add_time(_phase, now() - _start);
+    }
+
+private:
+    const phase_t _phase;
+    const boost::uint64_t _start;
+};
+
+}
+
+}
+
+#define XMLUTILS_STATS_CONCAT_IMPL(a, b) a##b
+#define XMLUTILS_STATS_CONCAT(a, b) XMLUTILS_STATS_CONCAT_IMPL(a, b)
+
+#ifdef XMLUTILS_STATS
+
+/** @brief Time the rest of the scope as a phase */
+#define XMLUTILS_STATS_PHASE(phase) \
+    xerces::stats::phase_timer XMLUTILS_STATS_CONCAT(xmlutils_phase_, __LINE__)(xerces::stats::phase)
+
+/** @brief Increase counter, value is not evaluated when compiled out */
+#define XMLUTILS_STATS_ADD(counter, value) \
+    xerces::stats::add(xerces::stats::counter, (value))
+
+#else
+
+#define XMLUTILS_STATS_PHASE(phase) ((void)0)
+#define XMLUTILS_STATS_ADD(counter, value) ((void)0)
+
+#endif
+
+#endif	/* STATS_H */
+
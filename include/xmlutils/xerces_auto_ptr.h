@@ -14,6 +14,7 @@
 #include <xercesc/util/XMLString.hpp>
 #include <xercesc/dom/DOM.hpp>
 #include <xalanc/XalanTransformer/XalanTransformer.hpp>
+#include "xmlutils/platform.h"
 
 XERCES_CPP_NAMESPACE_USE
 XALAN_CPP_NAMESPACE_USE
@@ -242,55 +243,39 @@ private:
  * for XMLPlatformUtils. <br>
  * It is unnesesary to perform any another operations with this wrapper,
  * it is just a context to perform any operations with XML documents.
+ * The platform is initialized once by the first wrapper and terminated
+ * by the last one, see <code>platform</code>.
  */
 template <>
 class xerces_auto_ptr<XMLPlatformUtils> : boost::noncopyable {
 public:
 
     /** @brief Default and the one constructor. <br>
-     * It is controlled by try-catch, so it can catch any XML-exceptions
-     * and throw it out of library
+     * XML-exceptions are thrown out of library as
+     * <code>std::runtime_error</code>
      */
-    xerces_auto_ptr() try {
-        XMLPlatformUtils::Initialize();
-    }
-    catch (const XMLException& toCatch) {
-        char *pMsg = XMLString::transcode(toCatch.getMessage());
-        std::string s(pMsg);
-        XMLString::release(&pMsg);
-        throw std::runtime_error(s.c_str());
-    }
+    xerces_auto_ptr() : _platform(platform::xerces_component) { }
 
-    /** @brief Terminate context */
-    ~xerces_auto_ptr() {
-	XMLPlatformUtils::Terminate();
-    }
+private:
+    /** @brief Reference to the initialized platform */
+    platform _platform;
 };
 
 //-----------------------------------------
 /** @brief A template class implements a pecialization XalanTransformer. <br>
  * XalanTransformer is an analog for XMLPlatformUtils, so it's just an
- * execution context.
+ * execution context. It is reference-counted as well.
  */
 XALAN_USING_XALAN(XalanTransformer)
 template <>
 class xerces_auto_ptr<XalanTransformer> : boost::noncopyable {
 public:
 
-    xerces_auto_ptr() {
-        XalanTransformer::initialize();
-    }
-
-    ~xerces_auto_ptr() {
-	XalanTransformer::terminate();
-	XalanTransformer::ICUCleanUp();
-    }
+    xerces_auto_ptr() : _platform(platform::transformer_component) { }
 
 private:
-    // Hide copy constructor and assignment operator
-    xerces_auto_ptr(const xerces_auto_ptr&);
-    xerces_auto_ptr & operator=(const xerces_auto_ptr&);
-
+    /** @brief Reference to the initialized transformer */
+    platform _platform;
 };
 
 }
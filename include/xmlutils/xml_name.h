@@ -0,0 +1,44 @@
+/* 
+ * File:   xml_name.h
+ * Author: ycherkasov
+ *
+ * Created on 26 Октябрь 2026 г., 11:40
+ */
+
+#ifndef XML_NAME_H
+#define	XML_NAME_H
+
+namespace xerces {
+
+/** @brief Scanner of XML names in XPath expressions.<br>
+ * Names are ASCII NCNames, other expressions are left to Xalan
+ * by the fast paths which use it.
+ */
+struct xml_name {
+
+    /** @brief Check if character can start a name */
+    static bool is_start(char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    /** @brief Check if character can continue a name */
+    static bool is_char(char c) {
+	return is_start(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+    }
+
+    /** @brief Skip name<br>
+     * @param s expression position
+     * @return end of the name, NULL if there is no name at s
+     *  */
+    static const char* skip(const char* s) {
+	if (!is_start(*s))
+	    return 0;
+	while (is_char(*s))
+	    ++s;
+	return s;
+    }
+};
+
+}
+
+#endif	/* XML_NAME_H */
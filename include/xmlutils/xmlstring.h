@@ -15,45 +15,107 @@
 namespace xerces{
 
 /** @brief This class implements RAII-wrapper under Xerces wide-char string.<br>
- * It is just a adapter for xerces_auto_ptr<XMLString> to implement more usable
- * and convenient interface.
+ * Short strings are kept in the inline buffer, so element and attribute
+ * names don't allocate at all. ASCII and UTF-8 input is converted directly,
+ * without the global transcoder; other strings are transcoded from the
+ * local code page as before.
  * */
 class string{
 public:
 
+    /** @brief Source encoding of narrow strings */
+    enum encoding_t {
+	/** @brief Local code page, ASCII is converted without transcoder */
+	local_code_page,
+	/** @brief UTF-8, converted without transcoder */
+	utf8
+    };
+
+    /** @brief Inline buffer size in wide chars, including terminator */
+    static const size_t inline_capacity = 64;
+
     /** @brief Construct XML wide-string from ASCII-string.
+     * Long strings are allocated with the memory manager provided,
+     * e.g. the arena of the document they are used with.
      * */
-    string(const char* s) : _str(s) { }
+    string(const char* s, encoding_t encoding = local_code_page
+	    , MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager);
 
     /** @brief Construct XML wide-string from XML wide char (UTF-16).
      * */
-    string(XMLCh* s) : _str(s) {}
+    string(XMLCh* s
+	    , MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager);
 
     /** @brief Construct XML wide-string from const XML wide char (UTF-16).
      * */
-    string(const XMLCh* s) : _str(s) {}
+    string(const XMLCh* s
+	    , MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager);
+
+    /** @brief Copy XML wide-string.
+     * */
+    string(const string& s);
+
+    string& operator=(const string& s);
+
+    ~string();
 
     /** @brief Get standard string
      * @return new std::string converted from XML string.
      * */
-    std::string get_string() const {
-	return _str.get_string();
-    }
+    std::string get_string() const;
+
+    /** @brief Get standard string in UTF-8
+     * @return new std::string converted from XML string.
+     * */
+    std::string get_utf8() const;
 
     /** @brief Get wide-char string
      * @return wide-char UTF-16 string.
      * */
     const XMLCh* get_wchar() const {
-        return _str.get();
+        return _data;
     }
 
+    /** @brief Get string length
+     * @return number of UTF-16 code units
+     * */
+    size_t length() const {
+	return _length;
+    }
 
 private:
-    /**@brief Smart string array we hold */
-    xerces_auto_ptr<const char* > _str;
+
+    /** @brief Copy wide chars to inline or heap buffer */
+    void assign(const XMLCh* s, size_t length);
+
+    /** @brief Convert 7-bit string to inline or heap buffer */
+    void assign_ascii(const char* s, size_t length);
+
+    /** @brief Convert UTF-8 string to inline or heap buffer */
+    void assign_utf8(const char* s, size_t length);
+
+    /** @brief Get buffer for <code>length</code> chars and terminator */
+    XMLCh* reserve(size_t length);
+
+    /** @brief Release heap buffer, if any */
+    void release();
+
+    /** @brief Inline buffer for short strings */
+    XMLCh _inline[inline_capacity];
+
+    /** @brief Heap buffer for long strings, NULL if not used */
+    XMLCh* _heap;
+
+    /** @brief String we hold, points to one of buffers */
+    const XMLCh* _data;
+
+    /** @brief String length */
+    size_t _length;
+
+    /** @brief Manager of heap buffer */
+    MemoryManager* _manager;
 };
 
 }
 
 #endif	/* STRING_H */
-
@@ -10,8 +10,13 @@
 
 #include <vector>
 #include <string>
+#include <utility>
+#include <limits>
+#include <stdexcept>
 #include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <xercesc/framework/LocalFileInputSource.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
 #include <xalanc/XPath/XPathEvaluator.hpp>
 #include <xalanc/XPath/XPathEnvSupportDefault.hpp>
 #include <xalanc/XPath/XObjectFactoryDefault.hpp>
@@ -20,10 +25,23 @@
 #include <xalanc/XPath/XPathConstructionContextDefault.hpp>
 #include <xalanc/XPath/XPathFactoryDefault.hpp>
 #include <xalanc/XPath/XPathProcessorImpl.hpp>
+#include <xalanc/XalanDOM/XalanDocument.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeInit.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeContentHandler.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeDocument.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeDOMSupport.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeParserLiaison.hpp>
+#include <xalanc/XercesParserLiaison/XercesParserLiaison.hpp>
+#include <xalanc/XercesParserLiaison/XercesDOMSupport.hpp>
 #include "xmlutils/xmlstring.h"
+#include "xmlutils/platform.h"
+#include "xmlutils/dom_document.h"
+#include "xmlutils/arena_memory_manager.h"
+#include "xmlutils/xpath_cache.h"
+#include "xmlutils/xpath_result.h"
+#include "xmlutils/path_index.h"
+#include "xmlutils/simple_path.h"
+#include "xmlutils/projection.h"
 
 namespace xerces {
 
@@ -34,7 +52,8 @@ namespace xerces {
  * numbers, or boolean values) from the content of an XML document.
  * See also http://en.wikipedia.org/wiki/XPath <br>
  * Result set can be given by <code>result()</code> function as a vector
- * of strings.
+ * of strings, or by <code>typed_result()</code> as number, boolean,
+ * string and node views.
  * @code
  *  xpath evaluator(filename);
  *  // call evaluate, passing in the XML string, the context string and the xpath string
@@ -53,8 +72,12 @@ class xpath : boost::noncopyable {
     struct helper_t {
 
         // do not change initialization order!
+        const bool _xerces_dom;
         XalanSourceTreeDOMSupport _dom_wrapper;
         XalanSourceTreeParserLiaison _liason_wrapper;
+        /** @brief Created for Xerces DOM queries only */
+        boost::scoped_ptr<XercesParserLiaison> _xerces_liaison;
+        boost::scoped_ptr<XercesDOMSupport> _xerces_dom_support;
         XPathEnvSupportDefault _environment_wrapper;
         XObjectFactoryDefault _xobject_factory;
         const ElementPrefixResolverProxy _prefix_resolver;
@@ -62,52 +85,227 @@ class xpath : boost::noncopyable {
         XPathConstructionContextDefault _construction_context;
         XPathFactoryDefault _xpath_factory;
         XPathProcessorImpl _xpath_processor;
-        XPath* const _xpath_context;
-        XPath* _xpath_exec_context;
 
 
         /** @brief XPath helper constructor<br>
          * @param root_elem root element of related DOM document. Can be NULL
+         * @param manager memory manager of parsed documents
+         * @param xerces_dom query Xerces DOM through the Xalan bridge
+         * instead of Xalan source tree
          *  */
-        helper_t(XalanElement * root_elem) : _dom_wrapper()
-        , _liason_wrapper(_dom_wrapper)
-        , _prefix_resolver(root_elem, _environment_wrapper, _dom_wrapper)
-        , _exec_context(_environment_wrapper, _dom_wrapper, _xobject_factory)
-        , _xpath_context(_xpath_factory.create()) {
+        helper_t(XalanElement * root_elem, MemoryManager& manager
+                , bool xerces_dom = false) : _xerces_dom(xerces_dom)
+        , _dom_wrapper()
+        , _liason_wrapper(_dom_wrapper, manager)
+        , _xerces_liaison(xerces_dom ? new XercesParserLiaison(manager) : 0)
+        , _xerces_dom_support(xerces_dom ? new XercesDOMSupport(*_xerces_liaison) : 0)
+        , _prefix_resolver(root_elem, _environment_wrapper, dom_support())
+        , _exec_context(_environment_wrapper, dom_support(), _xobject_factory) {
             _dom_wrapper.setParserLiaison(&_liason_wrapper);
         }
 
+        /** @brief DOM support of the documents queried */
+        DOMSupport& dom_support() {
+            if (_xerces_dom)
+                return *_xerces_dom_support;
+            return _dom_wrapper;
+        }
+
+        /** @brief Parse document with the selected liaison<br>
+         * Projection is applied to Xalan source tree only,
+         * Xerces DOM is parsed whole.
+         * @param source XML input source
+         * @param patterns subtrees to keep, NULL to keep the whole document
+         *  */
+        XalanDocument* parse(const InputSource& source
+                , const projection* patterns = 0) {
+            if (_xerces_dom)
+                return _xerces_liaison->parseXMLStream(source);
+            if (patterns == 0 || patterns->empty())
+                return _liason_wrapper.parseXMLStream(source);
+
+            // the document belongs to the liaison like a parsed one
+            XalanSourceTreeDocument* const document
+                    = _liason_wrapper.createXalanSourceTreeDocument();
+            XalanSourceTreeContentHandler builder(
+                    _liason_wrapper.getMemoryManager(), document);
+            projection_handler filter(*patterns, builder, &builder);
+            _liason_wrapper.parseXMLStream(source, filter, XalanDOMString(), 0, &filter);
+            return document;
+        }
+
+        /** @brief Wrap existing Xerces document without copying it.
+         * Nodes are wrapped on demand, so changes of the document
+         * require a new wrapper */
+        XalanDocument* wrap(const DOMDocument* document) {
+            return _xerces_liaison->createDocument(document, false, false);
+        }
+
+        /** @brief Destroy parsed or wrapped document */
+        void destroy(XalanDocument* document) {
+            if (_xerces_dom)
+                _xerces_liaison->destroyDocument(document);
+            else
+                _liason_wrapper.destroyDocument(document);
+        }
+
         
 
-        /** @brief XPath helper initialization<br>
-         * @param context context to perform XPath queries. Normally is root("/")
+        /** @brief Compile XPath expression<br>
+         * Compiled object belongs to the helper factory, it should be given
+         * back with <code>_xpath_factory.returnObject()</code> after use.
+         * @param expr XPath expression, e.g. root("/") for the context
+         * @return compiled XPath object
          *  */
-        void init(const XalanDOMString & context) {
-            _xpath_processor.initXPath(*_xpath_context, _construction_context
-                    , context, _prefix_resolver);
+        XPath* compile(const XalanDOMString & expr) {
+            XPath* const compiled = _xpath_factory.create();
+            try {
+                _xpath_processor.initXPath(*compiled, _construction_context
+                        , expr, _prefix_resolver);
+            }
+            catch (...) {
+                _xpath_factory.returnObject(compiled);
+                throw;
+            }
+            return compiled;
         }
 
     };
 public:
     
+    /** @brief XPath evaluator constructor without document<br>
+     * Xalan objects are created, but nothing is parsed until
+     * <code>open()</code> is called. Use it to prepare evaluators
+     * before handing them to other threads.
+     * @param policy global or arena memory for parsed documents
+     *  */
+    explicit xpath(memory_policy policy = default_memory_policy);
+
+    
     /** @brief XPath evaluator constructor<br>
      * @param filename XML file name
+     * @param policy global or arena memory for parsed documents
+     *  */
+    xpath(const std::string& filename
+            , memory_policy policy = default_memory_policy);
+
+    
+    /** @brief XPath evaluator constructor with load-time projection<br>
+     * Only subtrees matched by the projection are parsed into the tree,
+     * queries outside them find nothing.
+     * @code
+     *  xerces::projection servers;
+     *  servers.add("/root/server_settings");
+     *  xerces::xpath evaluator("export.xml", servers);
+     *  evaluator.evaluate("/root/server_settings/text()", "/");
+     * @endcode
+     * @param filename XML file name
+     * @param patterns subtrees to keep, copied by the evaluator
+     * @param policy global or arena memory for parsed documents
+     *  */
+    xpath(const std::string& filename, const projection& patterns
+            , memory_policy policy = default_memory_policy);
+
+    
+    /** @brief XPath evaluator constructor from memory buffer<br>
+     * The buffer is parsed in place without copying, it may be a received
+     * message or a <code>mapped_file</code> region. It must be alive
+     * as long as the evaluator, <code>reload()</code> parses it again.
+     * @param data XML document bytes
+     * @param size buffer size in bytes, <code>std::length_error</code> is thrown
+     * above 4 GB
+     * @param policy global or arena memory for parsed documents
+     *  */
+    xpath(const XMLByte* data, size_t size
+            , memory_policy policy = default_memory_policy);
+
+    
+    /** @brief XPath evaluator constructor from loaded document<br>
+     * The Xerces DOM of the document is queried through the Xalan
+     * bridge, without second parse and copy of the tree, so queries see
+     * unsaved changes. The bridge is rebuilt on the next query after
+     * the document revision changes. The document must outlive
+     * the evaluator.
+     * @code
+     *  xerces::dom_document settings("settings.xml");
+     *  settings.create_node("server_settings", "10.0.0.1");
+     *  xerces::xpath evaluator(settings);
+     *  evaluator.evaluate("/root/server_settings/text()", "/");
+     * @endcode
+     * @param document loaded or built document
      *  */
-    xpath(const std::string& filename);
+    explicit xpath(dom_document& document);
 
     ~xpath();
 
     
-    /** @brief XPath evaluator constructor<br>
-     * Given an xml document and an xpath context and expression in the form
-     * of (ascii) string objects, this function parses the XML document,
-     * evaluates the xpath and places the result as a class member,
-     * as a vector of string objects. It can be fetched with
-     * <code>result()</code> method.
+    /** @brief Parse another XML file<br>
+     * Xalan objects and compiled expressions are reused, so one evaluator
+     * may process many files. Nodes from the previous document
+     * become invalid. Arena memory is not released until the evaluator
+     * is destroyed, so evaluator with arena memory parses one document
+     * only and throws <code>std::logic_error</code> on the second one.
+     * @param filename XML file name
+     *  */
+    void open(const std::string& filename);
+
+    
+    /** @brief Parse XML file again<br>
+     * The document is parsed once on construction and kept alive for the
+     * whole evaluator lifetime, so all queries run against the same tree.
+     * Call this method if the file has been changed on disk.
+     * For <code>dom_document</code> source the bridge is rebuilt.
+     * Nodes from the previous document become invalid.
+     * Evaluator with arena memory throws <code>std::logic_error</code>,
+     * create a new one instead.
+     *  */
+    void reload();
+
+    
+    /** @brief Set projection of the next parsed documents<br>
+     * It is applied by <code>open()</code> and <code>reload()</code>,
+     * the current document is not changed.
+     * @param patterns subtrees to keep, copied by the evaluator;
+     * NULL to parse whole documents
+     *  */
+    void set_projection(const projection* patterns);
+
+    
+    /** @brief XPath query evaluation<br>
+     * Given an xpath context and expression in the form
+     * of (ascii) string objects, this function evaluates the xpath against
+     * the document parsed on construction and places the result as a class
+     * member. It can be fetched as a typed result with
+     * <code>typed_result()</code> or as a vector of strings with
+     * <code>result()</code> method. Previous result is dropped.
      * @param expr XPath expression
      * @param context XML document context
+     * @return typed query result, valid until the next query
+     *  */
+    const xpath_result& evaluate(const char* expr, const char* context);
+
+    
+    /** @brief XPath query: pair of expression and context */
+    typedef std::pair<std::string, std::string> query_t;
+
+    /** @brief Result sets of XPath queries batch */
+    typedef std::vector<std::vector<std::string> > batch_result_t;
+
+    
+    /** @brief Evaluate many XPath queries in one call<br>
+     * All queries share the parsed document, the prefix resolver and
+     * the execution context, so a full settings profile can be loaded
+     * in a single round trip.
+     * @code
+     *  std::vector<xpath::query_t> queries;
+     *  queries.push_back(xpath::query_t("/root/server_settings/text()", "/"));
+     *  queries.push_back(xpath::query_t("/root/color_settings/@line_color", "/"));
+     *  xpath::batch_result_t res = evaluator.evaluate_batch(queries);
+     * @endcode
+     * @param queries list of (expression, context) pairs
+     * @return one result set per query, in the same order
      *  */
-    void evaluate(const char* expr, const char* context);
+    batch_result_t evaluate_batch(const std::vector<query_t>& queries);
 
     
     /** @brief This method returns XPath query result as a vector of strings<br>
@@ -116,39 +314,189 @@ public:
      * @return XPath query result
      *  */
     const std::vector<std::string>& result() {
+        return _result.strings();
+    }
+
+    
+    /** @brief This method returns typed XPath query result<br>
+     * Number, boolean and node views are taken from the query result
+     * object directly, strings are transcoded on demand.
+     * @return XPath query result
+     *  */
+    const xpath_result& typed_result() const {
         return _result;
     }
 
+    
+    /** @brief Compiled expressions cache<br>
+     * It is shared by all queries of this evaluator, use it to read
+     * hit/miss counters or to change the capacity.
+     * @return cache of compiled (context, expression) pairs
+     *  */
+    xpath_cache& cache() {
+        return _cache;
+    }
+
+    
+    /** @brief Build absolute path index now and after every load<br>
+     * Queries of absolute child paths, e.g.
+     * <code>/root/server_settings/text()</code> or
+     * <code>/root/color_settings/@line_color</code>, against the root
+     * context are answered by the index without compilation and tree
+     * walk. Other queries are evaluated by Xalan as before.
+     * The index takes memory for every node, enable it for documents
+     * queried heavily and check <code>path_index_memory()</code>.
+     * @param enable build the index, or drop it if false
+     *  */
+    void enable_path_index(bool enable = true);
+
+    
+    /** @return true if the path index is enabled */
+    bool path_indexed() const {
+        return _path_index.get() != 0;
+    }
+
+    
+    /** @brief Evaluate simple location paths without Xalan<br>
+     * Paths like <code>/root/server_settings</code>,
+     * <code>//server_settings/text()</code> and <code>@line_color</code>
+     * are evaluated by <code>simple_path</code> with the same result,
+     * other expressions by Xalan. It is enabled by default.
+     * @param enable use native evaluator, or Xalan only if false
+     *  */
+    void enable_native(bool enable = true);
+
+    
+    /** @return true if the native evaluator is enabled */
+    bool native() const {
+        return _native;
+    }
+
+    
+    /** @return approximate memory taken by the path index in bytes,
+     * 0 if it is not enabled */
+    size_t path_index_memory() const {
+        return _path_index ? _path_index->memory() : 0;
+    }
+
+    
+    /** @return number of distinct paths in the index */
+    size_t path_index_paths() const {
+        return _path_index ? _path_index->paths() : 0;
+    }
+
 private:
 
+    
+    /** @brief Find compiled (context, expression) pair or compile it<br>
+     * @return cache entry valid until the next call
+     *  */
+    const xpath_cache::entry_t& compile(const char* expr, const char* context);
+
+    
+    /** @brief Evaluate XPath query<br>
+     * @param expr XPath expression
+     * @param context XML document context
+     * @param result query result to assign
+     *  */
+    void evaluate_to(const char* expr, const char* context
+            , xpath_result& result);
+
+    
+    /** @brief Evaluate absolute path query with the path index<br>
+     * @return false if the index is not enabled or can't answer the query
+     *  */
+    bool evaluate_indexed(const char* expr, const char* context
+            , xpath_result& result);
+
+    
+    /** @brief Evaluate simple location path query without Xalan<br>
+     * @return false if the evaluator is disabled or the query is out
+     * of its subset
+     *  */
+    bool evaluate_native(const char* expr, const char* context
+            , xpath_result& result);
+
+    
+    /** @brief Hold nodes as Xalan nodeset result<br>
+     * @param nodes nodes in document order, NULL for empty nodeset
+     * @param result query result to assign
+     *  */
+    void assign_nodes(const std::vector<XalanNode*>* nodes
+            , xpath_result& result);
+
     // do not change initialization order!
+
+    /** @brief XPathInit and XalanSourceTreeInit reference. <br>
+     * They are initialized once per process, not per evaluator */
+    platform _platform;
     
     /** @brief Xalan internal RAII-initializer. <br>
      * Must be existed while XPath evaluation performs
      * and result nodeset under processing */
     XPathEvaluator _evaluator;
 
-    /** @brief XPath result set */
-    std::vector<std::string> _result;
-
-    /** @brief XPath result set */
-    XPathInit _xpath_wrapper;
-
     /** @brief XML file name */
     XalanDOMString _filename;
 
     /** @brief XPath context */
     XalanDOMString theContext;
 
-    /** @brief XML input source */
-    const LocalFileInputSource _input_source;
-};
+    /** @brief XML input source, local file or memory buffer */
+    boost::scoped_ptr<const InputSource> _input_source;
+
+    /** @brief Memory buffer size, 0 for file input counted while read */
+    size_t _input_size;
+
+    /** @brief Subtrees kept by parse, NULL to keep the whole document */
+    boost::scoped_ptr<const projection> _projection;
+
+    /** @brief Arena of the parsed document, released with the evaluator.
+     * Liaison keeps its own objects in it, so it can't be reset */
+    boost::scoped_ptr<arena_memory_manager> _arena;
+
+    /** @brief Xalan objects kept for the evaluator lifetime */
+    helper_t _helper;
+
+    /** @brief Parsed document (owned by parser liaison) */
+    XalanDocument* _document;
+
+    /** @brief Queried dom_document, NULL for parsed input */
+    dom_document* _source;
+
+    /** @brief Revision of queried dom_document when it was wrapped */
+    size_t _source_revision;
 
+    /** @brief Absolute paths of the document, NULL if not enabled */
+    boost::scoped_ptr<path_index> _path_index;
 
-#if 0
+    /** @brief Simple paths are evaluated without Xalan */
+    bool _native;
 
+    /** @brief Compiled expressions, must be released before helper */
+    xpath_cache _cache;
+
+    /** @brief XPath result set, must be released before helper */
+    xpath_result _result;
+};
+
+
+/** @brief Evaluate XPath query against the root context and convert
+ * its first value.<br>
+ * Values are converted from the query result directly, without
+ * intermediate <code>std::string</code>. Integers are accepted in decimal
+ * and hexadecimal ("0x" prefix) notation, e.g. ARGB colors.
+ * Unsupported types and unconvertable values throw an exception.
+ * @code
+ *  xpath evaluator("settings.xml");
+ *  unsigned int color = evaluate_xpath<unsigned int>(evaluator, "/root/color_settings/@line_color");
+ * @endcode
+ * @param x XPath evaluator
+ * @param path XPath expression
+ * @return converted value
+ */
 template <typename T>
-T evaluate_xpath(const char* xml_file,
+T evaluate_xpath(xpath& x,
         const char* path) {
 
     throw std::runtime_error("unable to convert");
@@ -156,26 +504,82 @@ T evaluate_xpath(const char* xml_file,
 }
 
 template <>
-int evaluate_xpath<int>(const char* xml_file,
+inline long evaluate_xpath<long>(xpath& x,
         const char* path) {
 
-    xpath x(xml_file);
-    x.evaluate(path, "/");
-    std::string s = x.result().at(0);
-    return atoi(s.c_str());
+    long v = 0;
+    if (!x.evaluate(path, "/").to_integer(v))
+        throw std::runtime_error("unable to convert");
+    return v;
 }
 
 template <>
-std::string evaluate_xpath<std::string>(const char* xml_file,
+inline unsigned long evaluate_xpath<unsigned long>(xpath& x,
         const char* path) {
 
-    xpath x(xml_file);
-    x.evaluate(path, "/");
-    return x.result().at(0);
+    unsigned long v = 0;
+    if (!x.evaluate(path, "/").to_unsigned(v))
+        throw std::runtime_error("unable to convert");
+    return v;
+}
+
+template <>
+inline int evaluate_xpath<int>(xpath& x,
+        const char* path) {
+
+    const long v = evaluate_xpath<long>(x, path);
+    if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max())
+        throw std::runtime_error("unable to convert");
+    return static_cast<int>(v);
+}
+
+template <>
+inline unsigned int evaluate_xpath<unsigned int>(xpath& x,
+        const char* path) {
+
+    const unsigned long v = evaluate_xpath<unsigned long>(x, path);
+    if (v > std::numeric_limits<unsigned int>::max())
+        throw std::runtime_error("unable to convert");
+    return static_cast<unsigned int>(v);
+}
+
+template <>
+inline double evaluate_xpath<double>(xpath& x,
+        const char* path) {
+
+    return x.evaluate(path, "/").number();
+}
 
+template <>
+inline bool evaluate_xpath<bool>(xpath& x,
+        const char* path) {
+
+    return x.evaluate(path, "/").boolean();
 }
 
-#endif
+template <>
+inline std::string evaluate_xpath<std::string>(xpath& x,
+        const char* path) {
+
+    return x.evaluate(path, "/").string(0);
+
+}
+
+/** @brief Evaluate XPath query against the XML file and convert
+ * its first value.<br>
+ * Use the overload with <code>xpath</code> evaluator for more than one
+ * query, the file is parsed on every call.
+ * @param xml_file XML file name
+ * @param path XPath expression
+ * @return converted value
+ */
+template <typename T>
+T evaluate_xpath(const char* xml_file,
+        const char* path) {
+
+    xpath x(xml_file);
+    return evaluate_xpath<T>(x, path);
+}
 
 }
 
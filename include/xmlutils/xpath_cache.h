@@ -0,0 +1,123 @@
+/* 
+ * File:   xpath_cache.h
+ * Author: ycherkasov
+ *
+ * Created on 17 Октябрь 2026 г., 11:20
+ */
+
+#ifndef XPATH_CACHE_H
+#define	XPATH_CACHE_H
+
+#include <list>
+#include <string>
+#include <utility>
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+#include <xalanc/XPath/XPath.hpp>
+#include <xalanc/XPath/XPathFactory.hpp>
+
+XALAN_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief Bounded LRU cache of compiled XPath expressions.<br>
+ * Tokenizing and compiling an expression costs much more than executing
+ * it against a small document, so <code>xpath</code> keeps compiled
+ * objects keyed by (context, expression) strings. When the cache is full,
+ * the least recently used pair is given back to the XPath factory.
+ * Hit and miss counters help to choose the capacity.
+ * @code
+ *  xpath evaluator(filename);
+ *  evaluator.evaluate("/root/server_settings", "/");
+ *  evaluator.evaluate("/root/server_settings", "/");
+ *  assert(evaluator.cache().hits() == 1);
+ * @endcode
+ */
+class xpath_cache : boost::noncopyable {
+public:
+
+    /** @brief Compiled context and main expressions */
+    struct entry_t {
+        XPath* _context;
+        XPath* _expression;
+    };
+
+    /** @brief Default number of cached expression pairs */
+    static const size_t default_capacity = 64;
+
+    
+    /** @brief Cache constructor<br>
+     * @param factory factory owning the compiled objects
+     * @param capacity maximum number of cached pairs, at least one
+     *  */
+    xpath_cache(XPathFactory& factory, size_t capacity = default_capacity);
+
+    ~xpath_cache();
+
+    
+    /** @brief Find compiled pair and mark it as the most recently used<br>
+     * @return cached entry or NULL if it has not been compiled yet
+     *  */
+    const entry_t* find(const std::string& context, const std::string& expr);
+
+    
+    /** @brief Put compiled pair to the cache<br>
+     * The cache takes ownership of both objects. The least recently used
+     * pair is released if the cache is full.
+     * @return cached entry
+     *  */
+    const entry_t& insert(const std::string& context, const std::string& expr
+            , XPath* compiled_context, XPath* compiled_expr);
+
+    
+    /** @brief Release all compiled objects, counters are kept */
+    void clear();
+
+    
+    /** @brief Change maximum number of cached pairs */
+    void set_capacity(size_t capacity);
+
+    size_t capacity() const {
+        return _capacity;
+    }
+
+    size_t size() const {
+        return _index.size();
+    }
+
+    /** @brief Number of lookups found in cache */
+    unsigned long hits() const {
+        return _hits;
+    }
+
+    /** @brief Number of lookups required compilation */
+    unsigned long misses() const {
+        return _misses;
+    }
+
+private:
+
+    typedef std::pair<std::string, std::string> key_t;
+    typedef std::list<std::pair<key_t, entry_t> > lru_list_t;
+    typedef boost::unordered_map<key_t, lru_list_t::iterator> index_t;
+
+    /** @brief Give the least recently used entries back to factory */
+    void shrink(size_t capacity);
+
+    /** @brief Factory owning the compiled objects */
+    XPathFactory& _factory;
+
+    /** @brief Most recently used entries go first */
+    lru_list_t _lru;
+
+    /** @brief Fast lookup of list entries */
+    index_t _index;
+
+    size_t _capacity;
+    unsigned long _hits;
+    unsigned long _misses;
+};
+
+}
+
+#endif	/* XPATH_CACHE_H */
@@ -0,0 +1,125 @@
+/* 
+ * File:   xpath_executor.h
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 11:20
+ */
+
+#ifndef XPATH_EXECUTOR_H
+#define	XPATH_EXECUTOR_H
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include "xmlutils/xpath.h"
+
+namespace xerces {
+
+/** @brief This class runs the same XPath queries over many XML files
+ * with a fixed set of worker threads.<br>
+ * Every worker owns an <code>xpath</code> evaluator (Xalan environment,
+ * object factory and parser liaison) and reuses it from file to file.
+ * Files are split between workers in equal chunks; a worker which
+ * finished its chunk steals files from the tail of other queues.
+ * Results are returned in the order of input files. Errors are reported
+ * per file and don't stop the run.
+ * @code
+ *  xpath_executor executor(4);
+ *  std::vector<xpath::query_t> queries;
+ *  queries.push_back(xpath::query_t("/root/server_settings/text()", "/"));
+ *  xpath_executor::result_t res = executor.run(files, queries);
+ * @endcode
+ */
+class xpath_executor : boost::noncopyable {
+public:
+
+    /** @brief Query results of one file */
+    struct file_result_t {
+        /** @brief XML file name */
+        std::string _filename;
+        /** @brief One result set per query, empty on error */
+        xpath::batch_result_t _results;
+        /** @brief Error message, empty on success */
+        std::string _error;
+    };
+
+    /** @brief Results of all files, in the input order */
+    typedef std::vector<file_result_t> result_t;
+
+
+    /** @brief Executor constructor<br>
+     * Evaluators are created here, in the calling thread, so the
+     * first run doesn't pay for them.
+     * @param threads number of workers, 0 means number of hardware threads
+     *  */
+    explicit xpath_executor(size_t threads = 0);
+
+    ~xpath_executor();
+
+
+    /** @brief Evaluate all queries against every file<br>
+     * Blocks until all files are processed. Must not be called
+     * concurrently on the same executor.
+     * @param files list of XML file names
+     * @param queries list of (expression, context) pairs
+     * @return one result per file, in the same order
+     *  */
+    result_t run(const std::vector<std::string>& files
+            , const std::vector<xpath::query_t>& queries);
+
+
+    /** @brief Number of worker threads */
+    size_t threads() const {
+        return _workers.size();
+    }
+
+
+    /** @brief Number of files taken from other workers queues
+     * during the last run */
+    size_t stolen() const;
+
+private:
+
+    /** @brief Worker state: own evaluator and queue of file indexes */
+    struct worker_t : boost::noncopyable {
+        worker_t() : _evaluator(global_memory), _stolen(0) { }
+
+        /** @brief Evaluator reused for all files of the worker.
+         * Global memory, arena evaluator parses one file only */
+        xpath _evaluator;
+
+        /** @brief Indexes of files to process, owner takes from the front,
+         * thieves from the back */
+        std::deque<size_t> _queue;
+
+        /** @brief Queue lock */
+        boost::mutex _mutex;
+
+        /** @brief Files stolen by this worker */
+        size_t _stolen;
+    };
+
+
+    /** @brief Worker thread body */
+    void work(size_t id
+            , const std::vector<std::string>& files
+            , const std::vector<xpath::query_t>& queries
+            , result_t& results);
+
+
+    /** @brief Take next file index: own queue first, then steal<br>
+     * @return false when all queues are empty
+     *  */
+    bool next(size_t id, size_t& index);
+
+    /** @brief Workers, one per thread */
+    std::vector<boost::shared_ptr<worker_t> > _workers;
+};
+
+}
+
+#endif	/* XPATH_EXECUTOR_H */
+
@@ -0,0 +1,135 @@
+/* 
+ * File:   xpath_result.h
+ * Author: ycherkasov
+ *
+ * Created on 17 Октябрь 2026 г., 13:05
+ */
+
+#ifndef XPATH_RESULT_H
+#define	XPATH_RESULT_H
+
+#include <vector>
+#include <string>
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+#include <xalanc/XalanDOM/XalanNode.hpp>
+#include <xalanc/XPath/XObject.hpp>
+
+XALAN_CPP_NAMESPACE_USE
+
+namespace xerces {
+
+/** @brief Typed XPath query result.<br>
+ * It holds the <code>XObject</code> produced by Xalan and gives number,
+ * boolean, string and node views directly from it. Nothing is transcoded
+ * until <code>string()</code> or <code>strings()</code> is called, and
+ * transcoded strings are cached until the next query.
+ * The result belongs to the <code>xpath</code> evaluator and is valid
+ * until the next query or <code>reload()</code>.
+ * @code
+ *  xpath evaluator(filename);
+ *  const xpath_result& res = evaluator.evaluate("/root/color_settings/@line_color", "/");
+ *  unsigned long color = 0;
+ *  if(res.to_unsigned(color))
+ *      set_line_color(color);
+ * @endcode
+ */
+class xpath_result {
+public:
+
+    xpath_result();
+
+    
+    /** @brief Hold new XObject, previous views are dropped
+     * @param obj query result object
+     *  */
+    void assign(const XObjectPtr& obj);
+
+    
+    /** @brief Release held XObject, allocated buffers are kept for reuse */
+    void clear();
+
+    
+    /** @return true if no result is held */
+    bool empty() const {
+        return _object.null();
+    }
+
+    
+    /** @return true if the result is a nodeset */
+    bool is_nodeset() const;
+
+    
+    /** @return number of nodes for nodeset, 1 for scalar, 0 if empty */
+    size_t size() const;
+
+    
+    /** @brief Node handle<br>
+     * @param i node index, must be less than <code>size()</code>
+     * @return node of nodeset result, NULL for scalar result
+     *  */
+    XalanNode* node(size_t i) const;
+
+    
+    /** @brief Result converted with XPath number() rules */
+    double number() const;
+
+    
+    /** @brief Result converted with XPath boolean() rules */
+    bool boolean() const;
+
+    
+    /** @brief Untranscoded value string<br>
+     * For nodeset it is a value of node <code>i</code>: name of element,
+     * value of attribute, text, comment or processing instruction.
+     * For scalar it is the XPath string() value.
+     * @return reference to internal buffer valid until the next call
+     *  */
+    const XalanDOMString& value(size_t i = 0) const;
+
+    
+    /** @brief Value converted to signed integer<br>
+     * Decimal and hexadecimal ("0x" prefix) notations are accepted.
+     * @param v converted value
+     * @param i node index
+     * @return false if value is not an integer
+     *  */
+    bool to_integer(long& v, size_t i = 0) const;
+
+    
+    /** @brief Value converted to unsigned integer, e.g. ARGB color<br>
+     * Decimal and hexadecimal ("0x" prefix) notations are accepted.
+     * @param v converted value
+     * @param i node index
+     * @return false if value is not an unsigned integer
+     *  */
+    bool to_unsigned(unsigned long& v, size_t i = 0) const;
+
+    
+    /** @brief Value transcoded to standard string (lazy) */
+    const std::string& string(size_t i = 0) const;
+
+    
+    /** @brief All values transcoded to standard strings (lazy) */
+    const std::vector<std::string>& strings() const;
+
+private:
+
+    /** @brief Parse integer without sign from wide-char string */
+    static bool parse_unsigned(const XalanDOMChar* s, unsigned long& v);
+
+    /** @brief Query result object */
+    XObjectPtr _object;
+
+    /** @brief Buffer for node values */
+    mutable XalanDOMString _value;
+
+    /** @brief Transcoded values, valid if <code>_transcoded</code> is set */
+    mutable std::vector<std::string> _strings;
+
+    /** @brief Strings cache state */
+    mutable bool _transcoded;
+};
+
+}
+
+#endif	/* XPATH_RESULT_H */
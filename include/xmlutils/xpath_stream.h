@@ -0,0 +1,121 @@
+/* 
+ * File:   xpath_stream.h
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 10:15
+ */
+
+#ifndef XPATH_STREAM_H
+#define	XPATH_STREAM_H
+
+#include <vector>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include "xmlutils/xmlstring.h"
+
+namespace xerces {
+
+/** @brief It is a streaming XPath evaluator based on Xerces SAX2 parser.<br>
+ * Unlike <code>xpath</code>, it never builds a document tree, so memory
+ * usage does not depend on the file size. Matches are given to the
+ * handler as soon as the parser reaches them, and the handler may stop
+ * the parse when it has got what it needs.
+ * Only forward-only absolute paths are supported:
+ * <ul>
+ * <li>child (<code>/</code>) and descendant (<code>//</code>) steps</li>
+ * <li>element names and <code>*</code> wildcard</li>
+ * <li>attribute predicates <code>[@attr]</code> and
+ * <code>[@attr='value']</code></li>
+ * <li>final attribute step <code>/@attr</code></li>
+ * </ul>
+ * For element matches the handler gets the element text content,
+ * for attribute matches it gets the attribute value.
+ * @code
+ *  xpath_stream servers("//server_settings");
+ *  std::vector<std::string> first = servers.select("export.xml", 1);
+ * @endcode
+ */
+class xpath_stream : boost::noncopyable {
+public:
+
+    /** @brief Match handler, return false to stop the parse */
+    typedef boost::function<bool (const std::string&)> handler_t;
+
+    /** @brief Wide-char string used for compiled names and values */
+    typedef std::basic_string<XMLCh> xstring_t;
+
+    /** @brief Attribute predicate of the location step */
+    struct predicate_t {
+        xstring_t _attribute;
+        xstring_t _value;
+        bool _has_value;
+    };
+
+    /** @brief Location step */
+    struct step_t {
+        /** @brief Descendant axis if true, child axis otherwise */
+        bool _descendant;
+        /** @brief Element name, empty for wildcard */
+        xstring_t _name;
+        std::vector<predicate_t> _predicates;
+    };
+
+    
+    /** @brief Compile XPath expression<br>
+     * Xerces must be initialized. Expressions out of supported subset
+     * throw <code>std::runtime_error</code>.
+     * @param expr XPath expression
+     *  */
+    explicit xpath_stream(const char* expr);
+
+    
+    /** @brief Stream XML file through the expression<br>
+     * @param filename XML file name
+     * @param handler match handler
+     * @return number of matches given to the handler
+     *  */
+    size_t evaluate(const char* filename, handler_t handler) const;
+
+    
+    /** @brief Stream XML input source through the expression<br>
+     * @param source XML input source, e.g. MemBufInputSource
+     * @param handler match handler
+     * @return number of matches given to the handler
+     *  */
+    size_t evaluate(const InputSource& source, handler_t handler) const;
+
+    
+    /** @brief Collect matches into vector<br>
+     * @param filename XML file name
+     * @param max_count stop after this number of matches, 0 for all
+     * @return matched values in document order
+     *  */
+    std::vector<std::string> select(const char* filename, size_t max_count = 0) const;
+
+    
+    /** @brief Compiled location steps */
+    const std::vector<step_t>& steps() const {
+        return _steps;
+    }
+
+private:
+
+    /** @brief Parse one step with predicates starting at position pos */
+    static size_t parse_step(const std::string& expr, size_t pos, step_t& step);
+
+    /** @brief Parse input source (file name or InputSource) */
+    template <typename Source>
+    size_t parse(const Source& source, handler_t handler) const;
+
+    /** @brief Location steps */
+    std::vector<step_t> _steps;
+
+    /** @brief Final attribute step name, empty if none */
+    xstring_t _attribute;
+};
+
+}
+
+#endif	/* XPATH_STREAM_H */
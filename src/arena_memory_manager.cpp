@@ -0,0 +1,79 @@
+/* 
+ * File:   arena_memory_manager.cpp
+ * Author: ycherkasov
+ *
+ * Created on 19 Октябрь 2026 г., 13:15
+ */
+
+#include <new>
+#include "xmlutils/arena_memory_manager.h"
+
+using namespace xerces;
+
+namespace {
+
+// enough for any fundamental type
+const size_t arena_alignment = 16;
+
+size_t align(size_t size) {
+    return (size + arena_alignment - 1) & ~(arena_alignment - 1);
+}
+
+}
+
+//---------------------------------------------------------------
+arena_memory_manager::arena_memory_manager(size_t block_size/* = default_block_size*/)
+: _current(0)
+, _end(0)
+, _block_size(align(block_size))
+, _allocated(0)
+, _reserved(0) { }
+
+//---------------------------------------------------------------
+arena_memory_manager::~arena_memory_manager() {
+    reset();
+}
+
+//---------------------------------------------------------------
+void* arena_memory_manager::allocate(size_t size) {
+    size = align(size ? size : 1);
+    _allocated += size;
+
+    // large requests get dedicated blocks, current block stays in use
+    if (size > _block_size / 4) {
+	char* block = static_cast<char*>(::operator new(size));
+	_blocks.push_back(block);
+	_reserved += size;
+	return block;
+    }
+
+    if (static_cast<size_t>(_end - _current) < size)
+	_current = grow(_block_size);
+
+    void* p = _current;
+    _current += size;
+    return p;
+}
+
+//---------------------------------------------------------------
+void arena_memory_manager::deallocate(void* /*p*/) {
+}
+
+//---------------------------------------------------------------
+void arena_memory_manager::reset() {
+    for (size_t i = 0; i < _blocks.size(); ++i)
+	::operator delete(_blocks[i]);
+    _blocks.clear();
+    _current = _end = 0;
+    _allocated = _reserved = 0;
+}
+
+//---------------------------------------------------------------
+char* arena_memory_manager::grow(size_t size) {
+    _blocks.reserve(_blocks.size() + 1);
+    char* block = static_cast<char*>(::operator new(size));
+    _blocks.push_back(block);
+    _reserved += size;
+    _end = block + size;
+    return block;
+}
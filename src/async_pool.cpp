@@ -0,0 +1,197 @@
+/* 
+ * File:   async_pool.cpp
+ * Author: ycherkasov
+ *
+ * Created on 20 Октябрь 2026 г., 10:15
+ */
+
+#include <stdexcept>
+
+#include "xmlutils/async_pool.h"
+#include "xmlutils/error_message.h"
+
+using namespace xerces;
+
+namespace {
+
+// Run function and throw library exceptions as std::runtime_error,
+// so futures and callbacks get a message
+template <typename R>
+R guarded(const boost::function<R()>& f) {
+    try {
+        return f();
+    }
+    catch (const std::exception&) {
+        throw;
+    }
+    catch (...) {
+        throw std::runtime_error(current_error_message());
+    }
+}
+
+xpath::batch_result_t open_and_evaluate(xpath* evaluator
+        , const std::string& filename
+        , const std::vector<xpath::query_t>& queries) {
+    evaluator->open(filename);
+    return evaluator->evaluate_batch(queries);
+}
+
+xpath::batch_result_t wrap_and_evaluate(dom_document* document
+        , const std::vector<xpath::query_t>& queries) {
+    xpath evaluator(*document);
+    return evaluator.evaluate_batch(queries);
+}
+
+}
+
+//---------------------------------------------------------------
+async_pool::async_pool(size_t threads/* = 0*/
+        , size_t max_queue/* = default_max_queue*/)
+: _platform(platform::xpath_component)
+, _max_queue(max_queue ? max_queue : 1)
+, _stopping(false)
+, _thread_count(threads) {
+    if (_thread_count == 0)
+        _thread_count = boost::thread::hardware_concurrency();
+    if (_thread_count == 0)
+        _thread_count = 1;
+
+    for (size_t i = 0; i < _thread_count; ++i)
+        _threads.create_thread(boost::bind(&async_pool::work, this));
+}
+
+//---------------------------------------------------------------
+async_pool::~async_pool() {
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _stopping = true;
+    }
+    _not_empty.notify_all();
+    _threads.join_all();
+}
+
+//---------------------------------------------------------------
+boost::unique_future<async_pool::document_ptr>
+async_pool::open_document_async(const std::string& filename) {
+    return submit<document_ptr>(boost::bind(&async_pool::open, filename));
+}
+
+//---------------------------------------------------------------
+void async_pool::open_document_async(const std::string& filename
+        , const open_callback_t& done) {
+    post(boost::bind(&async_pool::open_notify, filename, done));
+}
+
+//---------------------------------------------------------------
+boost::unique_future<xpath::batch_result_t>
+async_pool::evaluate_async(const std::string& filename
+        , const std::vector<xpath::query_t>& queries) {
+    return submit<xpath::batch_result_t>(
+            boost::bind(&async_pool::evaluate_file, this, filename, queries));
+}
+
+//---------------------------------------------------------------
+boost::unique_future<xpath::batch_result_t>
+async_pool::evaluate_async(const document_ptr& document
+        , const std::vector<xpath::query_t>& queries) {
+    return submit<xpath::batch_result_t>(
+            boost::bind(&async_pool::evaluate_document, document, queries));
+}
+
+//---------------------------------------------------------------
+void async_pool::evaluate_async(const std::string& filename
+        , const std::vector<xpath::query_t>& queries
+        , const evaluate_callback_t& done) {
+    post(boost::bind(&async_pool::evaluate_notify, this, filename, queries, done));
+}
+
+//---------------------------------------------------------------
+size_t async_pool::pending() const {
+    boost::mutex::scoped_lock lock(_mutex);
+    return _queue.size();
+}
+
+//---------------------------------------------------------------
+void async_pool::post(const task_t& task) {
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        while (_queue.size() >= _max_queue)
+            _not_full.wait(lock);
+        _queue.push_back(task);
+    }
+    _not_empty.notify_one();
+}
+
+//---------------------------------------------------------------
+void async_pool::work() {
+    for (;;) {
+        task_t task;
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            while (_queue.empty() && !_stopping)
+                _not_empty.wait(lock);
+            if (_queue.empty())
+                return;
+            task.swap(_queue.front());
+            _queue.pop_front();
+        }
+        _not_full.notify_one();
+
+        // futures and callbacks get their own errors
+        task();
+    }
+}
+
+//---------------------------------------------------------------
+async_pool::document_ptr async_pool::open(const std::string& filename) {
+    document_ptr document(new dom_document(filename.c_str()));
+    // parse errors are not thrown by the document
+    if (document->document() == 0)
+        throw std::runtime_error("Unable to open XML document " + filename);
+    return document;
+}
+
+//---------------------------------------------------------------
+xpath::batch_result_t async_pool::evaluate_file(const std::string& filename
+        , const std::vector<xpath::query_t>& queries) {
+    if (_evaluator.get() == 0)
+        _evaluator.reset(new xpath(global_memory));
+
+    return guarded<xpath::batch_result_t>(boost::bind(&open_and_evaluate
+            , _evaluator.get(), boost::cref(filename), boost::cref(queries)));
+}
+
+//---------------------------------------------------------------
+xpath::batch_result_t async_pool::evaluate_document(const document_ptr& document
+        , const std::vector<xpath::query_t>& queries) {
+    return guarded<xpath::batch_result_t>(boost::bind(&wrap_and_evaluate
+            , document.get(), boost::cref(queries)));
+}
+
+//---------------------------------------------------------------
+void async_pool::open_notify(const std::string& filename, const open_callback_t& done) {
+    document_ptr document;
+    std::string error;
+    try {
+        document = open(filename);
+    }
+    catch (...) {
+        error = current_error_message();
+    }
+    done(document, error);
+}
+
+//---------------------------------------------------------------
+void async_pool::evaluate_notify(const std::string& filename
+        , const std::vector<xpath::query_t>& queries
+        , const evaluate_callback_t& done) {
+    xpath::batch_result_t results;
+    std::string error;
+    try {
+        results = evaluate_file(filename, queries);
+    }
+    catch (...) {
+        error = current_error_message();
+    }
+    done(results, error);
+}
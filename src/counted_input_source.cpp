@@ -0,0 +1,53 @@
+/* 
+ * File:   counted_input_source.cpp
+ * Author: ycherkasov
+ *
+ * Created on 26 Октябрь 2026 г., 12:30
+ */
+
+#include <xercesc/util/BinInputStream.hpp>
+
+#include "xmlutils/counted_input_source.h"
+#include "xmlutils/stats.h"
+
+using namespace xerces;
+
+namespace {
+
+// Stream which counts bytes read from the wrapped one
+class counted_stream : public BinInputStream {
+public:
+    explicit counted_stream(BinInputStream* stream)
+    : _stream(stream) { }
+
+    virtual unsigned int curPos() const {
+        return _stream->curPos();
+    }
+
+    virtual unsigned int readBytes(XMLByte* const toFill
+            , const unsigned int maxToRead) {
+        const unsigned int read = _stream->readBytes(toFill, maxToRead);
+        XMLUTILS_STATS_ADD(bytes_read, read);
+        return read;
+    }
+
+private:
+    boost::scoped_ptr<BinInputStream> _stream;
+};
+
+}
+
+//---------------------------------------------------------------
+counted_input_source::counted_input_source(InputSource* source)
+: InputSource(source->getSystemId())
+, _source(source) {
+    setPublicId(source->getPublicId());
+    setEncoding(source->getEncoding());
+    setIssueFatalErrorIfNotFound(source->getIssueFatalErrorIfNotFound());
+}
+
+//---------------------------------------------------------------
+BinInputStream* counted_input_source::makeStream() const {
+    BinInputStream* const stream = _source->makeStream();
+    return stream ? new counted_stream(stream) : 0;
+}
@@ -1,6 +1,10 @@
 #include <stdexcept>
 #include <errno.h>
+#include <xercesc/framework/LocalFileInputSource.hpp>
 #include "xmlutils/dom_document.h"
+#include "xmlutils/counted_input_source.h"
+#include "xmlutils/mapped_file.h"
+#include "xmlutils/stats.h"
 
 using namespace xerces;
 
@@ -24,79 +28,186 @@ using namespace xerces;
     std::cout << "Generic error occur" << std::endl;	\
     }							\
 
-//---------------------------------------------------------------
-void dom_document::open_document(const char* docname) {
+namespace {
+
+MemoryManager* select_manager(arena_memory_manager* arena) {
+    if (arena)
+	return arena;
+    return XMLPlatformUtils::fgMemoryManager;
+}
+
+// Parse input source with pooled or local parser.
+// The parsed document is adopted, so parser may be reused.
+// Pooled parsers use global memory and grammars of the pool,
+// arena documents, other grammars and projections get local parser.
+DOMDocument* parse_document(dom_parser_pool* pool
+	, MemoryManager* const manager
+	, const InputSource& source
+	, const parse_options& options) {
+    parse_errors errors;
+    ErrorHandler* const handler
+	    = (options._validation == parse_options::validate_always) ? &errors : 0;
+
+    const bool projected = options._projection && !options._projection->empty();
+    if (pool && manager == XMLPlatformUtils::fgMemoryManager && !projected
+	    && (options._grammars == 0 || options._grammars == pool->grammars())) {
+	parse_options pooled(options);
+	pooled._grammars = pool->grammars();
+
+	dom_parser_pool::lease parser(*pool);
+	dom_parser_pool::configure(*parser.get(), pooled);
+	parser->setErrorHandler(handler);
+	parser->parse(source);
+	errors.check();
+	return parser.adopt_document();
+    }
 
-    static XercesDOMParser::ValSchemes gValScheme = XercesDOMParser::Val_Auto;
-    static bool gDoNamespaces = false;
-    static bool gDoSchema = false;
-    static bool gSchemaFullChecking = false;
-    static bool gDoCreate = false;
+    XMLGrammarPool* const grammars = options._grammars ? options._grammars->pool() : 0;
+    boost::scoped_ptr<XercesDOMParser> parser(projected
+	    ? new projection_dom_parser(*options._projection, manager, grammars)
+	    : new XercesDOMParser(0, manager, grammars));
+    dom_parser_pool::configure(*parser, options);
+    parser->setErrorHandler(handler);
+    parser->parse(source);
+    errors.check();
+    return parser->adoptDocument();
+}
+
+}
+
+//---------------------------------------------------------------
+void dom_document::open_document(const char* docname, const parse_options& options) {
 
     //  Parse the XML file, catching any XML exceptions that might propogate
     //  out of it.
     TRY_XERCES_EXCEPTIONS
-    XercesDOMParser* parser = new XercesDOMParser;
-    parser->setValidationScheme(gValScheme);
-    parser->setDoNamespaces(gDoNamespaces);
-    parser->setDoSchema(gDoSchema);
-    parser->setValidationSchemaFullChecking(gSchemaFullChecking);
-    parser->setCreateEntityReferenceNodes(gDoCreate);
-#if 0
-    DOMTreeErrorReporter *errReporter = new DOMTreeErrorReporter();
-    parser->setErrorHandler(errReporter);
-#endif
-    parser->parse(docname);
-    _doc.assign(parser->getDocument());
+    // bytes are counted while the parser reads them
+    const counted_input_source source(new LocalFileInputSource(
+	    xerces::string(docname).get_wchar()));
+    XMLUTILS_STATS_PHASE(parse_phase);
+    // current document and arena are kept if the parse fails
+    boost::scoped_ptr<arena_memory_manager> arena(_arena ? new arena_memory_manager : 0);
+    replace_document(parse_document(_parser_pool, select_manager(arena.get())
+	    , source, options), arena);
+    ++_revision;
+    mark_clean();
+    rebuild_index();
+    XMLUTILS_STATS_ADD(documents_parsed, 1);
     RETHROW_XERCES_EXCEPTIONS
 
 }
 
 //---------------------------------------------------------------
-void dom_document::save_document() {
-    if(!_filename.empty())
-	save_document_as(_filename.c_str());
+void dom_document::open_document(const XMLByte* data, size_t size
+	, const parse_options& options) {
+
+    TRY_XERCES_EXCEPTIONS
+    // buffer is not adopted, so it is not copied or released
+    const MemBufInputSource source(data
+	    , buffer_size(size)
+	    , "dom_document buffer"
+	    , false);
+    XMLUTILS_STATS_PHASE(parse_phase);
+    boost::scoped_ptr<arena_memory_manager> arena(_arena ? new arena_memory_manager : 0);
+    replace_document(parse_document(_parser_pool, select_manager(arena.get())
+	    , source, options), arena);
+    ++_revision;
+    mark_clean();
+    rebuild_index();
+    XMLUTILS_STATS_ADD(documents_parsed, 1);
+    XMLUTILS_STATS_ADD(bytes_read, size);
+    RETHROW_XERCES_EXCEPTIONS
+
 }
 
 //---------------------------------------------------------------
-void dom_document::save_document_as(const char* xml_filename) {
-    TRY_XERCES_EXCEPTIONS
-    // --- Create DOM model
-    xerces::string x("LS 3.0");
-    DOMImplementation* dom_impl =
-	    DOMImplementationRegistry::getDOMImplementation(x.get_wchar());
-    if(dom_impl == 0)
-	throw std::runtime_error("DOM model does not supported");
+void dom_document::replace_document(DOMDocument* document
+	, boost::scoped_ptr<arena_memory_manager>& arena) {
+    // index and document go before their arena
+    if (_index)
+	_index->clear();
+    _doc.assign(document);
+    _arena.swap(arena);
+}
 
-    // --- DOM builder/writer factory class
-    DOMImplementationLS* dom_ls = static_cast<DOMImplementationLS*> (dom_impl);
+//---------------------------------------------------------------
+size_t dom_document::save_document(bool atomic/* = false*/) {
+    if(_filename.empty() || !is_dirty())
+	return 0;
 
-    // create DOM writer from factory
-    DOMWriter *dom_writer = dom_ls->createDOMWriter();
+    const size_t changed = changed_subtrees();
+    save_document_as(_filename.c_str(), atomic);
+    return changed;
+}
 
-    // --- set readable line ending
-    if (dom_writer->canSetFeature(XMLUni::fgDOMWRTFormatPrettyPrint, true))
-	dom_writer->setFeature(XMLUni::fgDOMWRTFormatPrettyPrint, true);
+//---------------------------------------------------------------
+void dom_document::save_document_as(const char* xml_filename
+	, bool atomic/* = false*/) {
+    TRY_XERCES_EXCEPTIONS
+    serializer().write_file(*_doc.get(), xml_filename, atomic);
+    mark_clean();
+    RETHROW_XERCES_EXCEPTIONS
+}
 
-    XMLFormatTarget *local_file_format_target =
-	    (LocalFileFormatTarget*)new LocalFileFormatTarget(xml_filename);
+//---------------------------------------------------------------
+void dom_document::mark_dirty(const DOMNode* node/* = 0*/) {
+    ++_revision;
 
-    if (!dom_writer->writeNode(local_file_format_target, *_doc.get()))
+    // find root element child containing the node
+    const DOMNode* const root = _doc->getDocumentElement();
+    if (node == 0 || node == root) {
+	_changed.insert(root);
 	return;
+    }
+    const DOMNode* parent = node->getParentNode();
+    while (parent != 0 && parent != root) {
+	node = parent;
+	parent = node->getParentNode();
+    }
+    // detached node belongs to no subtree yet, count it as document-wide
+    _changed.insert(parent == root ? node : root);
+}
 
-    dom_writer->release();
+//---------------------------------------------------------------
+size_t dom_document::save_to(std::string& buffer) {
+    size_t written = 0;
+    TRY_XERCES_EXCEPTIONS
+    written = serializer().write(*_doc.get(), buffer);
     RETHROW_XERCES_EXCEPTIONS
+    return written;
+}
+
+//---------------------------------------------------------------
+size_t dom_document::save_to(int fd) {
+    size_t written = 0;
+    TRY_XERCES_EXCEPTIONS
+    written = serializer().write(*_doc.get(), fd);
+    RETHROW_XERCES_EXCEPTIONS
+    return written;
+}
+
+//---------------------------------------------------------------
+dom_serializer& dom_document::serializer() {
+    if (!_serializer)
+	_serializer.reset(new dom_serializer);
+    return *_serializer;
 }
 
 //---------------------------------------------------------------
 DOMElement* dom_document::create_node(const char* const element_name
 	, const char* const node_value/* = 0*/
 	, DOMElement* parent_element/* = 0*/) {
+    return create_node(_names.intern(element_name), node_value, parent_element);
+}
+
+//---------------------------------------------------------------
+DOMElement* dom_document::create_node(name_table::name element_name
+	, const char* const node_value/* = 0*/
+	, DOMElement* parent_element/* = 0*/) {
 
     DOMElement* childElement = 0;
     TRY_XERCES_EXCEPTIONS
-    xerces::string x(element_name);
-    childElement = _doc->createElement(x.get_wchar());
+    childElement = _doc->createElement(element_name.get());
 
     // if no parent presented, create in root
     if (parent_element) {
@@ -107,21 +218,93 @@ DOMElement* dom_document::create_node(const char* const element_name
 
     // if value presented, set it
     if (node_value) {
+	xerces::string x(node_value, xerces::string::local_code_page, memory_manager());
 	DOMText* nodeValue = _doc->createTextNode(x.get_wchar());
 	childElement->appendChild(nodeValue);
     }
+    if (_index)
+	_index->add(childElement);
+    mark_dirty(childElement);
     RETHROW_XERCES_EXCEPTIONS
     return childElement;
 }
 
+//---------------------------------------------------------------
+size_t dom_document::append_nodes(const node_batch& batch
+	, DOMElement* parent_element/* = 0*/
+	, std::vector<DOMElement*>* created/* = 0*/) {
+    if (batch.empty())
+	return 0;
+
+    TRY_XERCES_EXCEPTIONS
+    // distinct names of the batch are looked up once
+    std::vector<name_table::name> names;
+    names.reserve(batch._names.size());
+    for (size_t i = 0; i < batch._names.size(); ++i)
+	names.push_back(_names.intern(batch._names[i].c_str()));
+
+    if (created)
+	created->reserve(created->size() + batch.size());
+
+    DOMElement* const parent = parent_element ? parent_element
+	    : _doc->getDocumentElement();
+    MemoryManager* const manager = memory_manager();
+
+    // elements of the root are changed subtrees themselves
+    const bool top_level = (parent == _doc->getDocumentElement());
+
+    size_t attr = 0;
+    for (size_t i = 0; i < batch._nodes.size(); ++i) {
+	const node_batch::node_t& n = batch._nodes[i];
+	DOMElement* const element = _doc->createElement(names[n._name].get());
+
+	for (; attr < n._attributes_end; ++attr) {
+	    const node_batch::attribute_t& a = batch._attributes[attr];
+	    xerces::string x(batch.value(a._value)
+		    , xerces::string::local_code_page, manager);
+	    element->setAttribute(names[a._name].get(), x.get_wchar());
+	}
+
+	if (n._value != node_batch::npos) {
+	    xerces::string x(batch.value(n._value)
+		    , xerces::string::local_code_page, manager);
+	    element->appendChild(_doc->createTextNode(x.get_wchar()));
+	}
+
+	parent->appendChild(element);
+	if (_index)
+	    _index->add(element);
+	if (created)
+	    created->push_back(element);
+	if (top_level)
+	    mark_dirty(element);
+    }
+    if (!top_level)
+	mark_dirty(parent);
+    RETHROW_XERCES_EXCEPTIONS
+    return batch.size();
+}
+
 //---------------------------------------------------------------
 void dom_document::create_attribute(DOMElement* node,
 	const char* const attr_name,
 	const char* const attr_value) {
+    create_attribute(node, _names.intern(attr_name), attr_value);
+}
+
+//---------------------------------------------------------------
+void dom_document::create_attribute(DOMElement* node,
+	name_table::name attr_name,
+	const char* const attr_value) {
     TRY_XERCES_EXCEPTIONS
-    xerces::string x_attr_name(attr_name);
-    xerces::string x_attr_value(attr_value);
-    node->setAttribute(x_attr_name.get_wchar(), x_attr_value.get_wchar());
+    xerces::string x_attr_value(attr_value
+	    , xerces::string::local_code_page, memory_manager());
+    if (_index)
+	_index->remove_attribute(node, attr_name.get());
+    node->setAttribute(attr_name.get(), x_attr_value.get_wchar());
+    if (_index)
+	_index->add_attribute(node, attr_name.get());
+    mark_dirty(node);
     RETHROW_XERCES_EXCEPTIONS
 }
 
@@ -132,16 +315,69 @@ void dom_document::set_attribute_value(DOMElement* node,
     create_attribute(node, attr_name, attr_value);
 }
 
+//---------------------------------------------------------------
+void dom_document::set_attribute_value(DOMElement* node,
+	name_table::name attr_name,
+	const char* const attr_value) {
+    create_attribute(node, attr_name, attr_value);
+}
+
 //---------------------------------------------------------------
 void dom_document::delete_node(DOMElement* delete_node) {
 
     TRY_XERCES_EXCEPTIONS
-    _doc->removeChild(delete_node);
+    // removed node can't be a changed subtree, its parent is
+    DOMNode* const parent = delete_node->getParentNode();
+    if (parent == 0)
+	return;
+    mark_dirty(parent);
+    _changed.erase(delete_node);
+    if (_index)
+	_index->remove_subtree(delete_node);
+    parent->removeChild(delete_node);
     RETHROW_XERCES_EXCEPTIONS
 }
 
 //---------------------------------------------------------------
-DOMDocument* dom_document::create_dom_document(const char* root) {
+void dom_document::enable_index(const std::vector<std::string>& attributes
+	/* = std::vector<std::string>()*/) {
+    _index.reset(new node_index(attributes));
+    rebuild_index();
+}
+
+//---------------------------------------------------------------
+void dom_document::rebuild_index() {
+    if (!_index)
+	return;
+
+    TRY_XERCES_EXCEPTIONS
+    if (_doc.get() && _doc->getDocumentElement())
+	_index->build(_doc->getDocumentElement());
+    else
+	_index->clear();
+    RETHROW_XERCES_EXCEPTIONS
+}
+
+//---------------------------------------------------------------
+const node_index::element_list_t& dom_document::elements_by_name(
+	const char* const element_name) const {
+    if (!_index)
+	throw std::logic_error("Document indexes are not enabled");
+    return _index->by_name(element_name);
+}
+
+//---------------------------------------------------------------
+const node_index::element_list_t& dom_document::elements_by_attribute(
+	const char* const attr_name
+	, const char* const attr_value) const {
+    if (!_index)
+	throw std::logic_error("Document indexes are not enabled");
+    return _index->by_attribute(attr_name, attr_value);
+}
+
+//---------------------------------------------------------------
+DOMDocument* dom_document::create_dom_document(const char* root
+	, MemoryManager* const manager/* = XMLPlatformUtils::fgMemoryManager*/) {
     // --- Create DOM model
     DOMDocument* doc = 0;
     TRY_XERCES_EXCEPTIONS
@@ -152,7 +388,7 @@ DOMDocument* dom_document::create_dom_document(const char* root) {
 	    DOMImplementationRegistry::getDOMImplementation(str1.get_wchar());
 
     // --- create DOM document with root
-    doc = dom_impl->createDocument(0, str_root.get_wchar(), 0);
+    doc = dom_impl->createDocument(0, str_root.get_wchar(), 0, manager);
 
     RETHROW_XERCES_EXCEPTIONS
     return doc;
@@ -0,0 +1,116 @@
+/* 
+ * File:   dom_parser_pool.cpp
+ * Author: ycherkasov
+ *
+ * Created on 17 Октябрь 2026 г., 15:40
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include "xmlutils/dom_parser_pool.h"
+#include "xmlutils/grammar_cache.h"
+#include "xmlutils/xmlstring.h"
+
+using namespace xerces;
+
+//---------------------------------------------------------------
+void parse_errors::check() const {
+    if (_errors)
+        throw std::runtime_error(_message);
+}
+
+//---------------------------------------------------------------
+void parse_errors::record(const SAXParseException& ex) {
+    if (_errors++)
+        return;
+
+    std::ostringstream err;
+    err << "Line " << ex.getLineNumber() << ": "
+            << xerces::string(ex.getMessage()).get_string();
+    _message = err.str();
+}
+
+//---------------------------------------------------------------
+dom_parser_pool::dom_parser_pool(size_t max_idle/* = default_max_idle*/
+        , grammar_cache* grammars/* = 0*/)
+: _max_idle(max_idle)
+, _created(0)
+, _grammars(grammars) { }
+
+//---------------------------------------------------------------
+dom_parser_pool::~dom_parser_pool() {
+    for (size_t i = 0; i < _idle.size(); ++i)
+        delete _idle[i];
+}
+
+//---------------------------------------------------------------
+XercesDOMParser* dom_parser_pool::checkout() {
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        if (!_idle.empty()) {
+            XercesDOMParser* parser = _idle.back();
+            _idle.pop_back();
+            return parser;
+        }
+        ++_created;
+    }
+
+    // construct outside the lock, it is the expensive part
+    XercesDOMParser* parser = new XercesDOMParser(0
+            , XMLPlatformUtils::fgMemoryManager
+            , _grammars ? _grammars->pool() : 0);
+    configure(*parser);
+    return parser;
+}
+
+//---------------------------------------------------------------
+void dom_parser_pool::checkin(XercesDOMParser* parser) {
+    if (parser == 0)
+        return;
+
+    // release documents which were not adopted
+    parser->resetDocumentPool();
+    parser->setErrorHandler(0);
+
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_idle.size() < _max_idle) {
+            _idle.push_back(parser);
+            return;
+        }
+    }
+    delete parser;
+}
+
+//---------------------------------------------------------------
+void dom_parser_pool::configure(XercesDOMParser& parser
+        , const parse_options& options/* = parse_options()*/) {
+    switch (options._validation) {
+    case parse_options::validate_never:
+        parser.setValidationScheme(XercesDOMParser::Val_Never);
+        break;
+    case parse_options::validate_always:
+        parser.setValidationScheme(XercesDOMParser::Val_Always);
+        break;
+    default:
+        parser.setValidationScheme(XercesDOMParser::Val_Auto);
+    }
+    parser.setDoNamespaces(options._namespaces || options._schema);
+    parser.setDoSchema(options._schema);
+    parser.setValidationSchemaFullChecking(options._schema_full_checking);
+    parser.setCreateEntityReferenceNodes(false);
+    parser.useCachedGrammarInParse(options._grammars != 0);
+    parser.cacheGrammarFromParse(options._grammars != 0 && options._cache_grammar);
+}
+
+//---------------------------------------------------------------
+size_t dom_parser_pool::idle() const {
+    boost::mutex::scoped_lock lock(_mutex);
+    return _idle.size();
+}
+
+//---------------------------------------------------------------
+size_t dom_parser_pool::created() const {
+    boost::mutex::scoped_lock lock(_mutex);
+    return _created;
+}
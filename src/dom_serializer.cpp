@@ -0,0 +1,282 @@
+/* 
+ * File:   dom_serializer.cpp
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 15:30
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <boost/detail/atomic_count.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+#include "xmlutils/dom_serializer.h"
+#include "xmlutils/xmlstring.h"
+#include "xmlutils/stats.h"
+
+using namespace xerces;
+
+namespace {
+
+std::string system_error(const char* what, const std::string& name, int error) {
+    return std::string(what) + " " + name + ": " + std::strerror(error);
+}
+
+// Appends output to std::string, formatter buffers it already
+class string_format_target : public XMLFormatTarget {
+public:
+    explicit string_format_target(std::string& buffer)
+    : _buffer(buffer)
+    , _written(0) { }
+
+    virtual void writeChars(const XMLByte* const toWrite
+            , const unsigned int count
+            , XMLFormatter* const) {
+        _buffer.append(reinterpret_cast<const char*>(toWrite), count);
+        _written += count;
+    }
+
+    size_t written() const {
+        return _written;
+    }
+
+private:
+    std::string& _buffer;
+    size_t _written;
+};
+
+// Collects output in a buffer and writes it to file descriptor.
+// Errors are kept until the writer returns, exceptions
+// mustn't pass through Xerces code.
+class fd_format_target : public XMLFormatTarget {
+public:
+    fd_format_target(int fd, size_t buffer_size)
+    : _fd(fd)
+    , _capacity(buffer_size ? buffer_size : 1)
+    , _written(0)
+    , _error(0) {
+        _buffer.reserve(_capacity);
+    }
+
+    virtual void writeChars(const XMLByte* const toWrite
+            , const unsigned int count
+            , XMLFormatter* const) {
+        if (_buffer.size() + count > _capacity)
+            flush();
+        // large chunk is not copied
+        if (count >= _capacity) {
+            write_all(toWrite, count);
+            return;
+        }
+        _buffer.insert(_buffer.end(), toWrite, toWrite + count);
+    }
+
+    virtual void flush() {
+        if (_buffer.empty())
+            return;
+        write_all(&_buffer[0], _buffer.size());
+        _buffer.clear();
+    }
+
+    size_t written() const {
+        return _written;
+    }
+
+    int error() const {
+        return _error;
+    }
+
+private:
+    void write_all(const XMLByte* data, size_t size) {
+        while (size > 0 && _error == 0) {
+            const ssize_t res = ::write(_fd, data, size);
+            if (res < 0) {
+                if (errno != EINTR)
+                    _error = errno;
+                continue;
+            }
+            data += res;
+            size -= static_cast<size_t>(res);
+            _written += static_cast<size_t>(res);
+        }
+    }
+
+    const int _fd;
+    const size_t _capacity;
+    std::vector<XMLByte> _buffer;
+    size_t _written;
+    int _error;
+};
+
+// Numbers temporary files of the process
+boost::detail::atomic_count temp_counter(0);
+
+// Create file with unique name next to the target. The kernel applies
+// umask to new file like to any other, so the process umask isn't touched.
+int create_temp_file(const std::string& target_name, std::string& temp_name) {
+    for (;;) {
+        std::ostringstream name;
+        name << target_name << '.' << ::getpid() << '.' << ++temp_counter;
+        const int fd = ::open(name.str().c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+        // left by a process with the same pid, take the next number
+        if (fd < 0 && errno == EEXIST)
+            continue;
+        if (fd >= 0)
+            temp_name = name.str();
+        return fd;
+    }
+}
+
+// Opens output file or temporary file in the same directory,
+// which is renamed over the target by commit().
+// Unfinished temporary file is removed.
+class output_file : boost::noncopyable {
+public:
+    output_file(const char* filename, bool atomic)
+    : _fd(-1)
+    , _target_name(filename) {
+        if (atomic) {
+            // rename is atomic in the same directory only
+            _fd = create_temp_file(_target_name, _temp_name);
+        }
+        else {
+            _fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        }
+        if (_fd < 0)
+            throw std::runtime_error(system_error("Unable to create", _target_name, errno));
+
+        // keep mode of the replaced file, new one has umask mode
+        struct stat st;
+        if (atomic && ::stat(filename, &st) == 0)
+            ::fchmod(_fd, st.st_mode & 07777);
+    }
+
+    ~output_file() {
+        if (_fd >= 0)
+            ::close(_fd);
+        if (!_temp_name.empty())
+            ::unlink(_temp_name.c_str());
+    }
+
+    int fd() const {
+        return _fd;
+    }
+
+    // Close file and replace the target with it
+    void commit() {
+        if (!_temp_name.empty() && ::fsync(_fd) != 0)
+            throw std::runtime_error(system_error("Unable to sync", _temp_name, errno));
+        const int res = ::close(_fd);
+        _fd = -1;
+        if (res != 0)
+            throw std::runtime_error(system_error("Unable to close", _target_name, errno));
+        if (!_temp_name.empty()) {
+            if (::rename(_temp_name.c_str(), _target_name.c_str()) != 0)
+                throw std::runtime_error(system_error("Unable to rename", _temp_name, errno));
+            _temp_name.clear();
+        }
+    }
+
+private:
+    int _fd;
+    const std::string _target_name;
+    std::string _temp_name;
+};
+
+}
+
+//---------------------------------------------------------------
+dom_serializer::dom_serializer(format_t format/* = pretty*/
+        , size_t buffer_size/* = default_buffer_size*/)
+: _writer(0)
+, _format(format)
+, _buffer_size(buffer_size) {
+    xerces::string x("LS");
+    DOMImplementation* dom_impl =
+            DOMImplementationRegistry::getDOMImplementation(x.get_wchar());
+    if (dom_impl == 0)
+        throw std::runtime_error("DOM model does not supported");
+
+    _writer = static_cast<DOMImplementationLS*> (dom_impl)->createDOMWriter();
+    set_format(format);
+}
+
+//---------------------------------------------------------------
+dom_serializer::~dom_serializer() {
+    _writer->release();
+}
+
+//---------------------------------------------------------------
+void dom_serializer::set_format(format_t format) {
+    _format = format;
+    const bool pretty_print = (format == pretty);
+    if (_writer->canSetFeature(XMLUni::fgDOMWRTFormatPrettyPrint, pretty_print))
+        _writer->setFeature(XMLUni::fgDOMWRTFormatPrettyPrint, pretty_print);
+}
+
+//---------------------------------------------------------------
+void dom_serializer::set_buffer_size(size_t buffer_size) {
+    _buffer_size = buffer_size;
+}
+
+//---------------------------------------------------------------
+size_t dom_serializer::write(const DOMNode& node, std::string& buffer) {
+    string_format_target target(buffer);
+    serialize(node, target);
+    XMLUTILS_STATS_ADD(bytes_written, target.written());
+    return target.written();
+}
+
+//---------------------------------------------------------------
+size_t dom_serializer::write(const DOMNode& node, int fd) {
+    fd_format_target target(fd, _buffer_size);
+    serialize(node, target);
+    target.flush();
+    if (target.error() != 0)
+        throw std::runtime_error(system_error("Unable to write", "descriptor", target.error()));
+    XMLUTILS_STATS_ADD(bytes_written, target.written());
+    return target.written();
+}
+
+//---------------------------------------------------------------
+size_t dom_serializer::write_file(const DOMNode& node, const char* filename
+        , bool atomic/* = false*/) {
+    output_file file(filename, atomic);
+    const size_t written = write(node, file.fd());
+    file.commit();
+    return written;
+}
+
+//---------------------------------------------------------------
+size_t dom_serializer::write_file(const std::string& data, const char* filename
+        , bool atomic/* = false*/) {
+    output_file file(filename, atomic);
+    const char* p = data.data();
+    size_t size = data.size();
+    while (size > 0) {
+        const ssize_t res = ::write(file.fd(), p, size);
+        if (res < 0 && errno == EINTR)
+            continue;
+        if (res < 0)
+            throw std::runtime_error(system_error("Unable to write", filename, errno));
+        p += res;
+        size -= static_cast<size_t>(res);
+    }
+    file.commit();
+    XMLUTILS_STATS_ADD(bytes_written, data.size());
+    return data.size();
+}
+
+//---------------------------------------------------------------
+void dom_serializer::serialize(const DOMNode& node, XMLFormatTarget& target) {
+    XMLUTILS_STATS_PHASE(serialize_phase);
+    if (!_writer->writeNode(&target, node))
+        throw std::runtime_error("Unable to serialize document");
+}
@@ -0,0 +1,36 @@
+/* 
+ * File:   error_message.cpp
+ * Author: ycherkasov
+ *
+ * Created on 26 Октябрь 2026 г., 10:20
+ */
+
+#include <stdexcept>
+#include <xercesc/sax/SAXException.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xalanc/PlatformSupport/XSLException.hpp>
+
+#include "xmlutils/error_message.h"
+#include "xmlutils/xmlstring.h"
+
+//---------------------------------------------------------------
+std::string xerces::current_error_message() {
+    try {
+        throw;
+    }
+    catch (const std::exception& ex) {
+        return ex.what();
+    }
+    catch (const XMLException& ex) {
+        return xerces::string(ex.getMessage()).get_string();
+    }
+    catch (const SAXException& ex) {
+        return xerces::string(ex.getMessage()).get_string();
+    }
+    catch (const XSLException& ex) {
+        return xerces::string(ex.getMessage().c_str()).get_string();
+    }
+    catch (...) {
+        return "Generic error occur";
+    }
+}
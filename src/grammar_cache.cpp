@@ -0,0 +1,81 @@
+/* 
+ * File:   grammar_cache.cpp
+ * Author: ycherkasov
+ *
+ * Created on 20 Октябрь 2026 г., 14:30
+ */
+
+#include <stdexcept>
+#include <xercesc/util/XMLException.hpp>
+
+#include "xmlutils/grammar_cache.h"
+#include "xmlutils/xmlstring.h"
+
+using namespace xerces;
+
+//---------------------------------------------------------------
+grammar_cache::grammar_cache()
+: _platform(platform::xerces_component)
+, _pool(new XMLGrammarPoolImpl(XMLPlatformUtils::fgMemoryManager))
+, _locked(false)
+, _preloaded(0) { }
+
+//---------------------------------------------------------------
+grammar_cache::~grammar_cache() { }
+
+//---------------------------------------------------------------
+void grammar_cache::preload_schema(const char* filename) {
+    preload(filename, Grammar::SchemaGrammarType);
+}
+
+//---------------------------------------------------------------
+void grammar_cache::preload_dtd(const char* filename) {
+    preload(filename, Grammar::DTDGrammarType);
+}
+
+//---------------------------------------------------------------
+void grammar_cache::lock() {
+    boost::mutex::scoped_lock lock(_mutex);
+    if (_locked)
+        return;
+    _pool->lockPool();
+    _locked = true;
+}
+
+//---------------------------------------------------------------
+bool grammar_cache::locked() const {
+    boost::mutex::scoped_lock lock(_mutex);
+    return _locked;
+}
+
+//---------------------------------------------------------------
+size_t grammar_cache::preloaded() const {
+    boost::mutex::scoped_lock lock(_mutex);
+    return _preloaded;
+}
+
+//---------------------------------------------------------------
+void grammar_cache::preload(const char* filename, Grammar::GrammarType type) {
+    boost::mutex::scoped_lock lock(_mutex);
+    if (_locked)
+        throw std::logic_error("Grammar cache is locked");
+
+    XercesDOMParser parser(0, XMLPlatformUtils::fgMemoryManager, _pool.get());
+    dom_parser_pool::configure(parser, parse_options::validated(this));
+
+    parse_errors errors;
+    parser.setErrorHandler(&errors);
+
+    Grammar* grammar = 0;
+    try {
+        grammar = parser.loadGrammar(filename, type, true);
+    }
+    catch (const XMLException& ex) {
+        throw std::runtime_error(xerces::string(ex.getMessage()).get_string());
+    }
+    errors.check();
+    if (grammar == 0)
+        throw std::runtime_error(std::string("Unable to load grammar ") + filename);
+
+    ++_preloaded;
+}
@@ -0,0 +1,38 @@
+/* 
+ * File:   name_table.cpp
+ * Author: ycherkasov
+ *
+ * Created on 19 Октябрь 2026 г., 10:40
+ */
+
+#include <cstring>
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include "xmlutils/name_table.h"
+#include "xmlutils/xmlstring.h"
+
+using namespace xerces;
+
+//---------------------------------------------------------------
+name_table::~name_table() {
+    for (table_t::iterator it = _names.begin(); it != _names.end(); ++it)
+	XMLPlatformUtils::fgMemoryManager->deallocate(it->second);
+}
+
+//---------------------------------------------------------------
+name_table::name name_table::intern(const char* n, bool utf8/* = false*/) {
+    // same bytes are different names in UTF-8 and local code page
+    std::string key(1, utf8 ? 'u' : 'l');
+    key += n;
+    table_t::iterator it = _names.find(key);
+    if (it != _names.end())
+	return name(it->second);
+
+    xerces::string x(n, utf8 ? xerces::string::utf8 : xerces::string::local_code_page);
+    const size_t bytes = (x.length() + 1) * sizeof(XMLCh);
+    XMLCh* pooled = static_cast<XMLCh*>(XMLPlatformUtils::fgMemoryManager->allocate(bytes));
+    std::memcpy(pooled, x.get_wchar(), bytes);
+
+    _names.insert(std::make_pair(key, pooled));
+    return name(pooled);
+}
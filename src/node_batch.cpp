@@ -0,0 +1,72 @@
+/* 
+ * File:   node_batch.cpp
+ * Author: ycherkasov
+ *
+ * Created on 19 Октябрь 2026 г., 14:20
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include "xmlutils/node_batch.h"
+
+using namespace xerces;
+
+//---------------------------------------------------------------
+void node_batch::reserve(size_t nodes, size_t attributes/* = 0*/
+        , size_t chars/* = 0*/) {
+    _nodes.reserve(nodes);
+    _attributes.reserve(attributes);
+    _chars.reserve(chars);
+}
+
+//---------------------------------------------------------------
+node_batch& node_batch::add(const char* name, const char* value/* = 0*/) {
+    node_t n;
+    n._name = name_index(name);
+    n._value = store(value);
+    n._attributes_end = _attributes.size();
+    _nodes.push_back(n);
+    return *this;
+}
+
+//---------------------------------------------------------------
+node_batch& node_batch::attribute(const char* name, const char* value) {
+    if (_nodes.empty())
+        throw std::logic_error("No element to add attribute");
+
+    attribute_t a;
+    a._name = name_index(name);
+    a._value = store(value ? value : "");
+    _attributes.push_back(a);
+    _nodes.back()._attributes_end = _attributes.size();
+    return *this;
+}
+
+//---------------------------------------------------------------
+void node_batch::clear() {
+    _nodes.clear();
+    _attributes.clear();
+    _chars.clear();
+}
+
+//---------------------------------------------------------------
+size_t node_batch::name_index(const char* name) {
+    const std::string key(name);
+    boost::unordered_map<std::string, size_t>::const_iterator it = _name_index.find(key);
+    if (it != _name_index.end())
+        return it->second;
+
+    _names.push_back(key);
+    _name_index.insert(std::make_pair(key, _names.size() - 1));
+    return _names.size() - 1;
+}
+
+//---------------------------------------------------------------
+size_t node_batch::store(const char* value) {
+    if (value == 0)
+        return npos;
+
+    const size_t offset = _chars.size();
+    _chars.insert(_chars.end(), value, value + std::strlen(value) + 1);
+    return offset;
+}
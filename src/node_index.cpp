@@ -0,0 +1,175 @@
+/*
+ * File:   node_index.cpp
+ * Author: ycherkasov
+ *
+ * Created on 20 Октябрь 2026 г., 17:10
+ */
+
+#include "xmlutils/node_index.h"
+#include "xmlutils/xmlstring.h"
+
+using namespace xerces;
+
+const node_index::element_list_t node_index::_empty;
+
+namespace {
+
+// Next element in document order within the subtree, NULL at its end
+DOMNode* next_node(DOMNode* node, const DOMNode* root) {
+    if (DOMNode* child = node->getFirstChild())
+        return child;
+    while (node != root) {
+        if (DOMNode* sibling = node->getNextSibling())
+            return sibling;
+        node = node->getParentNode();
+    }
+    return 0;
+}
+
+}
+
+//---------------------------------------------------------------
+node_index::node_index(const std::vector<std::string>& attributes)
+: _attributes(attributes.begin(), attributes.end()) { }
+
+//---------------------------------------------------------------
+void node_index::build(DOMElement* root) {
+    clear();
+    for (DOMNode* node = root; node != 0; node = next_node(node, root)) {
+        if (node->getNodeType() == DOMNode::ELEMENT_NODE)
+            add(static_cast<DOMElement*>(node));
+    }
+}
+
+//---------------------------------------------------------------
+void node_index::clear() {
+    _by_name.clear();
+    _by_attribute.clear();
+    // pooled names of the previous document may be reused
+    _narrow_names.clear();
+}
+
+//---------------------------------------------------------------
+void node_index::add(DOMElement* element) {
+    _by_name[narrow_name(element->getTagName())].push_back(element);
+
+    const DOMNamedNodeMap* const attrs = element->getAttributes();
+    const XMLSize_t count = attrs ? attrs->getLength() : 0;
+    for (XMLSize_t i = 0; i < count; ++i)
+        add_attribute(element, static_cast<const DOMAttr*>(attrs->item(i)));
+}
+
+//---------------------------------------------------------------
+void node_index::remove_subtree(DOMElement* root) {
+    for (DOMNode* node = root; node != 0; node = next_node(node, root)) {
+        if (node->getNodeType() == DOMNode::ELEMENT_NODE)
+            remove(static_cast<DOMElement*>(node));
+    }
+}
+
+//---------------------------------------------------------------
+void node_index::add_attribute(DOMElement* element, const XMLCh* name) {
+    if (const DOMAttr* attr = element->getAttributeNode(name))
+        add_attribute(element, attr);
+}
+
+//---------------------------------------------------------------
+void node_index::remove_attribute(DOMElement* element, const XMLCh* name) {
+    if (const DOMAttr* attr = element->getAttributeNode(name))
+        remove_attribute(element, attr);
+}
+
+//---------------------------------------------------------------
+const node_index::element_list_t& node_index::by_name(const std::string& name) const {
+    boost::unordered_map<std::string, list_t>::const_iterator it = _by_name.find(name);
+    return (it == _by_name.end()) ? _empty : it->second.elements();
+}
+
+//---------------------------------------------------------------
+const node_index::element_list_t& node_index::by_attribute(const std::string& name
+        , const std::string& value) const {
+    boost::unordered_map<attribute_key_t, list_t>::const_iterator it
+            = _by_attribute.find(attribute_key_t(name, value));
+    return (it == _by_attribute.end()) ? _empty : it->second.elements();
+}
+
+//---------------------------------------------------------------
+void node_index::add_attribute(DOMElement* element, const DOMAttr* attr) {
+    const std::string& name = narrow_name(attr->getName());
+    if (!indexed(name))
+        return;
+
+    const attribute_key_t key(name, xerces::string(attr->getValue()).get_string());
+    _by_attribute[key].push_back(element);
+}
+
+//---------------------------------------------------------------
+void node_index::remove_attribute(DOMElement* element, const DOMAttr* attr) {
+    const std::string& name = narrow_name(attr->getName());
+    if (!indexed(name))
+        return;
+
+    const attribute_key_t key(name, xerces::string(attr->getValue()).get_string());
+    boost::unordered_map<attribute_key_t, list_t>::iterator it = _by_attribute.find(key);
+    if (it != _by_attribute.end() && it->second.erase(element))
+        _by_attribute.erase(it);
+}
+
+//---------------------------------------------------------------
+void node_index::remove(DOMElement* element) {
+    boost::unordered_map<std::string, list_t>::iterator it
+            = _by_name.find(narrow_name(element->getTagName()));
+    if (it != _by_name.end() && it->second.erase(element))
+        _by_name.erase(it);
+
+    const DOMNamedNodeMap* const attrs = element->getAttributes();
+    const XMLSize_t count = attrs ? attrs->getLength() : 0;
+    for (XMLSize_t i = 0; i < count; ++i)
+        remove_attribute(element, static_cast<const DOMAttr*>(attrs->item(i)));
+}
+
+//---------------------------------------------------------------
+const std::string& node_index::narrow_name(const XMLCh* name) {
+    boost::unordered_map<const XMLCh*, std::string>::iterator it = _narrow_names.find(name);
+    if (it == _narrow_names.end())
+        it = _narrow_names.insert(std::make_pair(name, xerces::string(name).get_string())).first;
+    return it->second;
+}
+
+//---------------------------------------------------------------
+void node_index::list_t::push_back(DOMElement* element) {
+    if (_positions.count(element))
+        return;
+    _positions.insert(std::make_pair(element, _elements.size()));
+    _elements.push_back(element);
+}
+
+//---------------------------------------------------------------
+bool node_index::list_t::erase(DOMElement* element) {
+    boost::unordered_map<DOMElement*, size_t>::iterator it = _positions.find(element);
+    if (it != _positions.end()) {
+        _elements[it->second] = 0;
+        _positions.erase(it);
+        ++_removed;
+    }
+    return _positions.empty();
+}
+
+//---------------------------------------------------------------
+const node_index::element_list_t& node_index::list_t::elements() const {
+    if (_removed == 0)
+        return _elements;
+
+    // holes are removed keeping the order, positions are shifted
+    size_t live = 0;
+    for (size_t i = 0; i < _elements.size(); ++i) {
+        if (_elements[i] == 0)
+            continue;
+        _elements[live] = _elements[i];
+        _positions[_elements[live]] = live;
+        ++live;
+    }
+    _elements.resize(live);
+    _removed = 0;
+    return _elements;
+}
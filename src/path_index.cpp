@@ -0,0 +1,139 @@
+/* 
+ * File:   path_index.cpp
+ * Author: ycherkasov
+ *
+ * Created on 21 Октябрь 2026 г., 10:20
+ */
+
+#include <xalanc/XalanDOM/XalanElement.hpp>
+#include <xalanc/XalanDOM/XalanNamedNodeMap.hpp>
+
+#include "xmlutils/path_index.h"
+#include "xmlutils/simple_path.h"
+#include "xmlutils/xmlstring.h"
+#include "xmlutils/xml_name.h"
+
+using namespace xerces;
+
+namespace {
+
+// Namespace declarations are not XPath attributes
+bool is_namespace_declaration(const std::string& name) {
+    return name.compare(0, 5, "xmlns") == 0
+            && (name.size() == 5 || name[5] == ':');
+}
+
+// Names are pooled by the document, so they are transcoded once
+class name_cache {
+public:
+    const std::string& narrow(const XalanDOMString& name) {
+        boost::unordered_map<const XalanDOMString*, std::string>::iterator it
+                = _names.find(&name);
+        if (it == _names.end())
+            it = _names.insert(std::make_pair(&name
+                    , xerces::string(name.c_str()).get_string())).first;
+        return it->second;
+    }
+
+private:
+    boost::unordered_map<const XalanDOMString*, std::string> _names;
+};
+
+}
+
+//---------------------------------------------------------------
+path_index::path_index()
+: _nodes(0) { }
+
+//---------------------------------------------------------------
+void path_index::build(const XalanDocument* document) {
+    clear();
+    XalanNode* const root = document ? document->getDocumentElement() : 0;
+    // unprefixed paths match elements without namespace only
+    if (root == 0 || !root->getNamespaceURI().empty())
+        return;
+
+    name_cache names;
+    std::string path;
+    // path length before every open element
+    std::vector<size_t> open;
+
+    XalanNode* node = root;
+    for (;;) {
+        const XalanNode::NodeType type = node->getNodeType();
+        if (type == XalanNode::ELEMENT_NODE && !node->getNamespaceURI().empty()) {
+            // nothing below is reachable by unprefixed path
+        }
+        else if (type == XalanNode::ELEMENT_NODE) {
+            open.push_back(path.size());
+            path += '/';
+            path += names.narrow(node->getNodeName());
+            add(path, node);
+
+            const XalanNamedNodeMap* const attrs = node->getAttributes();
+            const unsigned int count = attrs ? attrs->getLength() : 0;
+            for (unsigned int i = 0; i < count; ++i) {
+                XalanNode* const attr = attrs->item(i);
+                const std::string& name = names.narrow(attr->getNodeName());
+                if (!is_namespace_declaration(name) && attr->getNamespaceURI().empty())
+                    add(path + "/@" + name, attr);
+            }
+
+            if (XalanNode* const child = node->getFirstChild()) {
+                node = child;
+                continue;
+            }
+            path.resize(open.back());
+            open.pop_back();
+        }
+        else if (type == XalanNode::TEXT_NODE || type == XalanNode::CDATA_SECTION_NODE) {
+            add(path + "/text()", node);
+        }
+
+        // climb to the first ancestor with next sibling, closing elements
+        while (node != root && node->getNextSibling() == 0) {
+            node = node->getParentNode();
+            path.resize(open.back());
+            open.pop_back();
+        }
+        if (node == root)
+            break;
+        node = node->getNextSibling();
+    }
+}
+
+//---------------------------------------------------------------
+void path_index::clear() {
+    _paths.clear();
+    _nodes = 0;
+}
+
+//---------------------------------------------------------------
+bool path_index::indexable(const char* expr) {
+    simple_path path;
+    return path.parse(expr) && path.child_path();
+}
+
+//---------------------------------------------------------------
+const path_index::node_list_t* path_index::find(const std::string& path) const {
+    paths_t::const_iterator it = _paths.find(path);
+    return (it == _paths.end()) ? 0 : &it->second;
+}
+
+//---------------------------------------------------------------
+size_t path_index::memory() const {
+    // hash node holds the pair and the next pointer, bucket is a pointer
+    size_t bytes = _paths.bucket_count() * sizeof(void*);
+    for (paths_t::const_iterator it = _paths.begin(); it != _paths.end(); ++it) {
+        bytes += sizeof(paths_t::value_type) + 2 * sizeof(void*);
+        bytes += it->first.capacity();
+        bytes += it->second.capacity() * sizeof(XalanNode*);
+    }
+    return bytes;
+}
+
+//---------------------------------------------------------------
+void path_index::add(const std::string& path, XalanNode* node) {
+    _paths[path].push_back(node);
+    ++_nodes;
+}
@@ -0,0 +1,160 @@
+/* 
+ * File:   platform.cpp
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 13:10
+ */
+
+#include <cassert>
+#include <stdexcept>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/once.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xalanc/XPath/XPathInit.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeInit.hpp>
+#include <xalanc/XalanTransformer/XalanTransformer.hpp>
+
+#include "xmlutils/platform.h"
+#include "xmlutils/xmlstring.h"
+
+XALAN_CPP_NAMESPACE_USE
+
+using namespace xerces;
+
+namespace {
+
+// POD state is ready before any static constructor may use a guard
+struct state_t {
+    size_t _references;
+    size_t _initializations;
+};
+
+state_t g_state[platform::component_count];
+
+XPathInit* g_xpath_init = 0;
+XalanSourceTreeInit* g_source_tree_init = 0;
+
+// mutex is created once on first use and never destroyed,
+// guards may be released from static destructors
+boost::mutex* g_mutex = 0;
+boost::once_flag g_mutex_once = BOOST_ONCE_INIT;
+
+void create_mutex() {
+    g_mutex = new boost::mutex;
+}
+
+boost::mutex& platform_mutex() {
+    boost::call_once(g_mutex_once, &create_mutex);
+    return *g_mutex;
+}
+
+void initialize(platform::component_t component) {
+    switch (component) {
+    case platform::xerces_component:
+        XMLPlatformUtils::Initialize();
+        break;
+    case platform::xpath_component:
+        g_xpath_init = new XPathInit;
+        g_source_tree_init = new XalanSourceTreeInit;
+        break;
+    case platform::transformer_component:
+        XalanTransformer::initialize();
+        break;
+    default:
+        assert(false);
+    }
+}
+
+void terminate(platform::component_t component) {
+    switch (component) {
+    case platform::xerces_component:
+        XMLPlatformUtils::Terminate();
+        break;
+    case platform::xpath_component:
+        delete g_source_tree_init;
+        g_source_tree_init = 0;
+        delete g_xpath_init;
+        g_xpath_init = 0;
+        break;
+    case platform::transformer_component:
+        XalanTransformer::terminate();
+        XalanTransformer::ICUCleanUp();
+        break;
+    default:
+        assert(false);
+    }
+}
+
+// must be called under the platform mutex
+void add_reference(platform::component_t component) {
+    state_t& state = g_state[component];
+    if (state._references == 0) {
+        try {
+            initialize(component);
+        }
+        catch (const XMLException& ex) {
+            throw std::runtime_error(xerces::string(ex.getMessage()).get_string());
+        }
+        ++state._initializations;
+    }
+    ++state._references;
+}
+
+// must be called under the platform mutex
+void remove_reference(platform::component_t component) {
+    state_t& state = g_state[component];
+    assert(state._references > 0);
+    if (--state._references == 0)
+        terminate(component);
+}
+
+}
+
+//---------------------------------------------------------------
+platform::platform(component_t component/* = xpath_component*/)
+: _component(component) {
+    acquire(_component);
+}
+
+//---------------------------------------------------------------
+platform::~platform() {
+    release(_component);
+}
+
+//---------------------------------------------------------------
+void platform::acquire(component_t component) {
+    boost::mutex::scoped_lock lock(platform_mutex());
+
+    // Xalan components require Xerces platform
+    if (component != xerces_component)
+        add_reference(xerces_component);
+    try {
+        add_reference(component);
+    }
+    catch (...) {
+        if (component != xerces_component)
+            remove_reference(xerces_component);
+        throw;
+    }
+}
+
+//---------------------------------------------------------------
+void platform::release(component_t component) {
+    boost::mutex::scoped_lock lock(platform_mutex());
+    remove_reference(component);
+    if (component != xerces_component)
+        remove_reference(xerces_component);
+}
+
+//---------------------------------------------------------------
+size_t platform::references(component_t component) {
+    boost::mutex::scoped_lock lock(platform_mutex());
+    return g_state[component]._references;
+}
+
+//---------------------------------------------------------------
+size_t platform::initializations(component_t component) {
+    boost::mutex::scoped_lock lock(platform_mutex());
+    return g_state[component]._initializations;
+}
@@ -0,0 +1,575 @@
+/* 
+ * File:   projection.cpp
+ * Author: ycherkasov
+ *
+ * Created on 23 Октябрь 2026 г., 15:10
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+
+#include "xmlutils/projection.h"
+#include "xmlutils/xmlstring.h"
+#include "xmlutils/xml_name.h"
+
+using namespace xerces;
+
+namespace {
+
+// Local part of the qualified name
+const XMLCh* local_name(const XMLCh* name) {
+    const XMLCh* local = name;
+    for (const XMLCh* s = name; *s != 0; ++s) {
+        if (*s == chColon)
+            local = s + 1;
+    }
+    return local;
+}
+
+// Skip predicate at s, return its end
+const char* skip_predicate(const char* s, const char* pattern) {
+    size_t depth = 0;
+    char quote = 0;
+    for (; *s != 0; ++s) {
+        if (quote) {
+            if (*s == quote)
+                quote = 0;
+        }
+        else if (*s == '\'' || *s == '"') {
+            quote = *s;
+        }
+        else if (*s == '[') {
+            ++depth;
+        }
+        else if (*s == ']' && --depth == 0) {
+            return s + 1;
+        }
+    }
+    throw std::runtime_error(std::string("Unclosed predicate in projection ") + pattern);
+}
+
+// Skip NCName at s, non-ASCII UTF-8 bytes are name characters.
+// Return its end, NULL if there is no name at s
+const char* skip_ncname(const char* s) {
+    if (!xml_name::is_start(*s) && static_cast<unsigned char>(*s) < 0x80)
+        return 0;
+    while (xml_name::is_char(*s) || static_cast<unsigned char>(*s) >= 0x80)
+        ++s;
+    return s;
+}
+
+// Skip name test (QName or *) at s, return its end, NULL if there is none
+const char* skip_name_test(const char* s) {
+    if (*s == '*')
+        return s + 1;
+    s = skip_ncname(s);
+    if (s != 0 && *s == ':')
+        s = skip_ncname(s + 1);
+    return s;
+}
+
+// Copy of string which may be NULL
+projection::xstring_t copy(const XMLCh* s) {
+    return s ? projection::xstring_t(s) : projection::xstring_t();
+}
+
+// Attributes of held back element start, five strings per attribute
+class stored_attributes : public Attributes {
+public:
+    explicit stored_attributes(const std::vector<projection::xstring_t>& attrs)
+    : _attrs(attrs) { }
+
+    virtual unsigned int getLength() const {
+        return static_cast<unsigned int>(_attrs.size() / fields);
+    }
+
+    virtual const XMLCh* getURI(const unsigned int index) const {
+        return field(index, 0);
+    }
+
+    virtual const XMLCh* getLocalName(const unsigned int index) const {
+        return field(index, 1);
+    }
+
+    virtual const XMLCh* getQName(const unsigned int index) const {
+        return field(index, 2);
+    }
+
+    virtual const XMLCh* getType(const unsigned int index) const {
+        return field(index, 3);
+    }
+
+    virtual const XMLCh* getValue(const unsigned int index) const {
+        return field(index, 4);
+    }
+
+    virtual int getIndex(const XMLCh* const uri, const XMLCh* const localPart) const {
+        for (unsigned int i = 0; i < getLength(); ++i) {
+            if (_attrs[i * fields].compare(uri) == 0
+                    && _attrs[i * fields + 1].compare(localPart) == 0)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    virtual int getIndex(const XMLCh* const qName) const {
+        for (unsigned int i = 0; i < getLength(); ++i) {
+            if (_attrs[i * fields + 2].compare(qName) == 0)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    virtual const XMLCh* getType(const XMLCh* const uri, const XMLCh* const localPart) const {
+        return field(getIndex(uri, localPart), 3);
+    }
+
+    virtual const XMLCh* getType(const XMLCh* const qName) const {
+        return field(getIndex(qName), 3);
+    }
+
+    virtual const XMLCh* getValue(const XMLCh* const uri, const XMLCh* const localPart) const {
+        return field(getIndex(uri, localPart), 4);
+    }
+
+    virtual const XMLCh* getValue(const XMLCh* const qName) const {
+        return field(getIndex(qName), 4);
+    }
+
+private:
+    static const size_t fields = 5;
+
+    const XMLCh* field(int index, size_t n) const {
+        if (index < 0 || static_cast<size_t>(index) >= getLength())
+            return 0;
+        return _attrs[index * fields + n].c_str();
+    }
+
+    const std::vector<projection::xstring_t>& _attrs;
+};
+
+}
+
+//---------------------------------------------------------------
+projection::projection() { }
+
+//---------------------------------------------------------------
+projection::projection(const std::vector<std::string>& patterns) {
+    for (size_t i = 0; i < patterns.size(); ++i)
+        add(patterns[i].c_str());
+}
+
+//---------------------------------------------------------------
+void projection::add(const char* pattern) {
+    const char* s = pattern;
+    if (*s != '/')
+        throw std::runtime_error(std::string("Not an absolute path in projection ") + pattern);
+
+    pattern_t steps;
+    while (*s != 0) {
+        const bool descendant = (s[0] == '/' && s[1] == '/');
+        if (*s != '/')
+            throw std::runtime_error(std::string("Unsupported projection ") + pattern);
+        s += descendant ? 2 : 1;
+
+        if (std::strncmp(s, "child::", 7) == 0)
+            s += 7;
+
+        // attributes and text belong to the element
+        const char* last = 0;
+        if (*s == '@')
+            last = skip_name_test(s + 1);
+        else if (std::strncmp(s, "text()", 6) == 0 || std::strncmp(s, "node()", 6) == 0)
+            last = s + 6;
+        if (*s == 0 || last != 0) {
+            if (last != 0 && *last != 0)
+                throw std::runtime_error(std::string("Unsupported projection ") + pattern);
+            break;
+        }
+
+        const char* end = skip_name_test(s);
+        if (end == 0 || (*end != 0 && *end != '/' && *end != '['))
+            throw std::runtime_error(std::string("Unsupported projection ") + pattern);
+        std::string name(s, end);
+
+        step_t step;
+        step._descendant = descendant;
+        if (name != "*") {
+            const std::string::size_type colon = name.rfind(':');
+            if (colon != std::string::npos)
+                name.erase(0, colon + 1);
+            const xerces::string wide(name.c_str(), xerces::string::utf8);
+            step._name = wide.get_wchar();
+        }
+        steps.push_back(step);
+
+        s = end;
+        while (*s == '[')
+            s = skip_predicate(s, pattern);
+    }
+
+    // "/" and "//@attr" keep everything
+    if (steps.empty()) {
+        step_t any;
+        any._descendant = true;
+        steps.push_back(any);
+    }
+    _patterns.push_back(steps);
+}
+
+//---------------------------------------------------------------
+projection::matcher::matcher(const projection& patterns)
+: _patterns(patterns) { }
+
+//---------------------------------------------------------------
+projection::decision_t projection::matcher::enter(const XMLCh* name) {
+    const bool root = _open.empty();
+    if (!root && _open.back()._inside) {
+        _open.push_back(_open.back());
+        return keep_subtree;
+    }
+
+    // first steps of all patterns are looked for by the root element
+    std::vector<position_t> first;
+    if (root) {
+        for (size_t i = 0; i < _patterns.patterns().size(); ++i)
+            first.push_back(position_t(i, 0));
+    }
+    const std::vector<position_t>& positions = root ? first : _open.back()._positions;
+
+    const XMLCh* const local = local_name(name);
+    open_t next;
+    next._inside = false;
+    next._used = false;
+    for (size_t i = 0; i < positions.size() && !next._inside; ++i) {
+        const pattern_t& pattern = _patterns.patterns()[positions[i].first];
+        const step_t& step = pattern[positions[i].second];
+        if (step._descendant
+                && std::find(next._positions.begin(), next._positions.end(), positions[i])
+                    == next._positions.end())
+            next._positions.push_back(positions[i]);
+
+        if (!step._name.empty() && step._name.compare(local) != 0)
+            continue;
+
+        if (positions[i].second + 1 == pattern.size()) {
+            next._inside = true;
+        }
+        else {
+            const position_t following(positions[i].first, positions[i].second + 1);
+            if (std::find(next._positions.begin(), next._positions.end(), following)
+                    == next._positions.end())
+                next._positions.push_back(following);
+        }
+    }
+
+    if (next._inside) {
+        next._positions.clear();
+        _open.push_back(next);
+        return keep_subtree;
+    }
+    // document must have the root element
+    if (next._positions.empty() && !root)
+        return skip_subtree;
+    _open.push_back(next);
+    return keep_element;
+}
+
+//---------------------------------------------------------------
+bool projection::matcher::leave() {
+    const bool kept = _open.back()._inside || _open.back()._used;
+    _open.pop_back();
+    // document must have the root element
+    if (_open.empty())
+        return true;
+    if (kept)
+        _open.back()._used = true;
+    return kept;
+}
+
+//---------------------------------------------------------------
+bool projection::matcher::text_kept() const {
+    return !_open.empty() && _open.back()._inside;
+}
+
+//---------------------------------------------------------------
+projection_dom_parser::projection_dom_parser(const projection& patterns
+        , MemoryManager* const manager/* = XMLPlatformUtils::fgMemoryManager*/
+        , XMLGrammarPool* const grammars/* = 0*/)
+: XercesDOMParser(0, manager, grammars)
+, _matcher(patterns)
+, _skipped(0) { }
+
+//---------------------------------------------------------------
+void projection_dom_parser::startElement(const XMLElementDecl& elemDecl
+        , const unsigned int urlId
+        , const XMLCh* const elemPrefix
+        , const RefVectorOf<XMLAttr>& attrList
+        , const unsigned int attrCount
+        , const bool isEmpty
+        , const bool isRoot) {
+    // empty element gets no endElement() from the scanner
+    if (_skipped) {
+        if (!isEmpty)
+            ++_skipped;
+        return;
+    }
+    if (_matcher.enter(elemDecl.getBaseName()) == projection::skip_subtree) {
+        if (!isEmpty)
+            _skipped = 1;
+        return;
+    }
+    // base class closes empty element through endElement() below
+    XercesDOMParser::startElement(elemDecl, urlId, elemPrefix
+            , attrList, attrCount, isEmpty, isRoot);
+}
+
+//---------------------------------------------------------------
+void projection_dom_parser::endElement(const XMLElementDecl& elemDecl
+        , const unsigned int urlId
+        , const bool isRoot
+        , const XMLCh* const elemPrefix) {
+    if (_skipped) {
+        --_skipped;
+        return;
+    }
+    const bool kept = _matcher.leave();
+    XercesDOMParser::endElement(elemDecl, urlId, isRoot, elemPrefix);
+    if (!kept) {
+        // the element just closed is the last child of the current parent
+        fCurrentParent->removeChild(fCurrentNode)->release();
+        fCurrentNode = fCurrentParent;
+    }
+}
+
+//---------------------------------------------------------------
+void projection_dom_parser::docCharacters(const XMLCh* const chars
+        , const unsigned int length
+        , const bool cdataSection) {
+    if (content_kept())
+        XercesDOMParser::docCharacters(chars, length, cdataSection);
+}
+
+//---------------------------------------------------------------
+void projection_dom_parser::ignorableWhitespace(const XMLCh* const chars
+        , const unsigned int length
+        , const bool cdataSection) {
+    if (content_kept())
+        XercesDOMParser::ignorableWhitespace(chars, length, cdataSection);
+}
+
+//---------------------------------------------------------------
+void projection_dom_parser::docComment(const XMLCh* const comment) {
+    if (content_kept())
+        XercesDOMParser::docComment(comment);
+}
+
+//---------------------------------------------------------------
+void projection_dom_parser::docPI(const XMLCh* const target, const XMLCh* const data) {
+    if (content_kept())
+        XercesDOMParser::docPI(target, data);
+}
+
+//---------------------------------------------------------------
+void projection_dom_parser::startEntityReference(const XMLEntityDecl& entDecl) {
+    if (!_skipped)
+        XercesDOMParser::startEntityReference(entDecl);
+}
+
+//---------------------------------------------------------------
+void projection_dom_parser::endEntityReference(const XMLEntityDecl& entDecl) {
+    if (!_skipped)
+        XercesDOMParser::endEntityReference(entDecl);
+}
+
+//---------------------------------------------------------------
+void projection_dom_parser::resetDocument() {
+    _matcher.reset();
+    _skipped = 0;
+    XercesDOMParser::resetDocument();
+}
+
+//---------------------------------------------------------------
+bool projection_dom_parser::content_kept() const {
+    return !_skipped && (_matcher.top_level() || _matcher.text_kept());
+}
+
+//---------------------------------------------------------------
+projection_handler::projection_handler(const projection& patterns
+        , ContentHandler& content
+        , LexicalHandler* lexical/* = 0*/)
+: _matcher(patterns)
+, _content(content)
+, _lexical(lexical)
+, _skipped(0) { }
+
+//---------------------------------------------------------------
+void projection_handler::startElement(const XMLCh* const uri
+        , const XMLCh* const localname
+        , const XMLCh* const qname
+        , const Attributes& attrs) {
+    if (_skipped) {
+        ++_skipped;
+        return;
+    }
+    // local name is empty without namespaces processing
+    const XMLCh* const name = (localname && *localname) ? localname : qname;
+    const bool root = _matcher.top_level();
+    const projection::decision_t decision = _matcher.enter(name);
+    if (decision == projection::skip_subtree) {
+        _skipped = 1;
+        return;
+    }
+    // element on the way is passed when something inside it is kept
+    if (decision == projection::keep_element && !root) {
+        pending_t pending;
+        pending._uri = copy(uri);
+        pending._localname = copy(localname);
+        pending._qname = copy(qname);
+        for (unsigned int i = 0; i < attrs.getLength(); ++i) {
+            pending._attrs.push_back(copy(attrs.getURI(i)));
+            pending._attrs.push_back(copy(attrs.getLocalName(i)));
+            pending._attrs.push_back(copy(attrs.getQName(i)));
+            pending._attrs.push_back(copy(attrs.getType(i)));
+            pending._attrs.push_back(copy(attrs.getValue(i)));
+        }
+        _pending.push_back(pending);
+        return;
+    }
+    flush();
+    _content.startElement(uri, localname, qname, attrs);
+}
+
+//---------------------------------------------------------------
+void projection_handler::endElement(const XMLCh* const uri
+        , const XMLCh* const localname
+        , const XMLCh* const qname) {
+    if (_skipped) {
+        --_skipped;
+        return;
+    }
+    // dropped element is the innermost held back one
+    if (!_matcher.leave()) {
+        _pending.pop_back();
+        return;
+    }
+    _content.endElement(uri, localname, qname);
+}
+
+//---------------------------------------------------------------
+void projection_handler::characters(const XMLCh* const chars, const unsigned int length) {
+    if (content_kept())
+        _content.characters(chars, length);
+}
+
+//---------------------------------------------------------------
+void projection_handler::ignorableWhitespace(const XMLCh* const chars, const unsigned int length) {
+    if (content_kept())
+        _content.ignorableWhitespace(chars, length);
+}
+
+//---------------------------------------------------------------
+void projection_handler::processingInstruction(const XMLCh* const target, const XMLCh* const data) {
+    if (content_kept())
+        _content.processingInstruction(target, data);
+}
+
+//---------------------------------------------------------------
+void projection_handler::setDocumentLocator(const Locator* const locator) {
+    _content.setDocumentLocator(locator);
+}
+
+//---------------------------------------------------------------
+void projection_handler::startDocument() {
+    _matcher.reset();
+    _pending.clear();
+    _skipped = 0;
+    _content.startDocument();
+}
+
+//---------------------------------------------------------------
+void projection_handler::endDocument() {
+    _content.endDocument();
+}
+
+//---------------------------------------------------------------
+void projection_handler::startPrefixMapping(const XMLCh* const prefix, const XMLCh* const uri) {
+    // comes before the element start, so it is not filtered
+    _content.startPrefixMapping(prefix, uri);
+}
+
+//---------------------------------------------------------------
+void projection_handler::endPrefixMapping(const XMLCh* const prefix) {
+    _content.endPrefixMapping(prefix);
+}
+
+//---------------------------------------------------------------
+void projection_handler::skippedEntity(const XMLCh* const name) {
+    if (!_skipped)
+        _content.skippedEntity(name);
+}
+
+//---------------------------------------------------------------
+void projection_handler::comment(const XMLCh* const chars, const unsigned int length) {
+    if (_lexical && content_kept())
+        _lexical->comment(chars, length);
+}
+
+//---------------------------------------------------------------
+void projection_handler::startCDATA() {
+    if (_lexical && content_kept())
+        _lexical->startCDATA();
+}
+
+//---------------------------------------------------------------
+void projection_handler::endCDATA() {
+    if (_lexical && content_kept())
+        _lexical->endCDATA();
+}
+
+//---------------------------------------------------------------
+void projection_handler::startDTD(const XMLCh* const name
+        , const XMLCh* const publicId
+        , const XMLCh* const systemId) {
+    if (_lexical)
+        _lexical->startDTD(name, publicId, systemId);
+}
+
+//---------------------------------------------------------------
+void projection_handler::endDTD() {
+    if (_lexical)
+        _lexical->endDTD();
+}
+
+//---------------------------------------------------------------
+void projection_handler::startEntity(const XMLCh* const name) {
+    if (_lexical && !_skipped)
+        _lexical->startEntity(name);
+}
+
+//---------------------------------------------------------------
+void projection_handler::endEntity(const XMLCh* const name) {
+    if (_lexical && !_skipped)
+        _lexical->endEntity(name);
+}
+
+//---------------------------------------------------------------
+bool projection_handler::content_kept() const {
+    return !_skipped && (_matcher.top_level() || _matcher.text_kept());
+}
+
+
+//---------------------------------------------------------------
+void projection_handler::flush() {
+    for (size_t i = 0; i < _pending.size(); ++i) {
+        const pending_t& pending = _pending[i];
+        const stored_attributes attrs(pending._attrs);
+        _content.startElement(pending._uri.c_str(), pending._localname.c_str()
+                , pending._qname.c_str(), attrs);
+    }
+    _pending.clear();
+}
\ No newline at end of file
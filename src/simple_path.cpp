@@ -0,0 +1,189 @@
+/* 
+ * File:   simple_path.cpp
+ * Author: ycherkasov
+ *
+ * Created on 21 Октябрь 2026 г., 14:45
+ */
+
+#include <cstring>
+#include <string>
+#include <boost/unordered_set.hpp>
+#include <xalanc/XalanDOM/XalanNamedNodeMap.hpp>
+
+#include "xmlutils/simple_path.h"
+#include "xmlutils/xml_name.h"
+
+using namespace xerces;
+
+namespace {
+
+// Next node of the subtree in document order, NULL at its end
+XalanNode* next_node(XalanNode* node, const XalanNode* root) {
+    if (XalanNode* child = node->getFirstChild())
+        return child;
+    while (node != root) {
+        if (XalanNode* sibling = node->getNextSibling())
+            return sibling;
+        node = node->getParentNode();
+    }
+    return 0;
+}
+
+}
+
+//---------------------------------------------------------------
+simple_path::simple_path()
+: _absolute(false) { }
+
+//---------------------------------------------------------------
+bool simple_path::parse(const char* expr) {
+    _steps.clear();
+    const char* s = expr;
+    _absolute = (*s == '/');
+    if (_absolute && s[1] == 0)
+        return true;
+
+    for (;;) {
+        step_t step;
+        step._axis = child_axis;
+        if (s[0] == '/' && s[1] == '/') {
+            step._axis = descendant_axis;
+            s += 2;
+        }
+        else if (s[0] == '/') {
+            ++s;
+        }
+        else if (s != expr) {
+            return false;
+        }
+
+        const char* name = s;
+        if (*s == '@') {
+            step._test = attribute_test;
+            name = s + 1;
+            s = xml_name::skip(name);
+        }
+        else if (std::strncmp(s, "text()", 6) == 0) {
+            step._test = text_test;
+            s += 6;
+        }
+        else if (*s == '*') {
+            step._test = any_element_test;
+            ++s;
+        }
+        else {
+            step._test = element_test;
+            s = xml_name::skip(s);
+        }
+        if (s == 0)
+            return false;
+
+        if (step._test == element_test || step._test == attribute_test)
+            step._name = std::string(name, s).c_str();
+        _steps.push_back(step);
+
+        if (*s == 0)
+            return true;
+        // attribute and text have no children
+        if (step._test == attribute_test || step._test == text_test || *s != '/')
+            return false;
+    }
+}
+
+//---------------------------------------------------------------
+bool simple_path::child_path() const {
+    if (!_absolute || _steps.empty())
+        return false;
+    for (size_t i = 0; i < _steps.size(); ++i) {
+        if (_steps[i]._axis != child_axis || _steps[i]._test == any_element_test)
+            return false;
+        // the document node has no text
+        if (i == 0 && _steps[i]._test == text_test)
+            return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------
+bool simple_path::evaluate(XalanNode* context, node_list_t& result) const {
+    result.clear();
+
+    XalanNode* start = context;
+    if (_absolute && start->getNodeType() != XalanNode::DOCUMENT_NODE)
+        start = start->getOwnerDocument();
+
+    node_list_t current(1, start);
+    node_list_t next;
+    for (size_t i = 0; i < _steps.size() && !current.empty(); ++i) {
+        next.clear();
+        for (size_t j = 0; j < current.size(); ++j)
+            select(current[j], _steps[i], next);
+        current.swap(next);
+
+        // children of nested elements would be out of document order
+        if (_steps[i]._axis == descendant_axis && i + 1 < _steps.size()
+                && current.size() > 1 && nested(current))
+            return false;
+    }
+    result.swap(current);
+    return true;
+}
+
+//---------------------------------------------------------------
+void simple_path::select(XalanNode* node, const step_t& step, node_list_t& result) {
+    if (step._test == attribute_test) {
+        // attributes of the node itself and, for "//", of its descendants
+        for (XalanNode* n = node; n != 0
+                ; n = (step._axis == descendant_axis) ? next_node(n, node) : 0) {
+            if (n->getNodeType() != XalanNode::ELEMENT_NODE)
+                continue;
+            const XalanNamedNodeMap* const attrs = n->getAttributes();
+            XalanNode* const attr = attrs ? attrs->getNamedItem(step._name) : 0;
+            if (attr != 0 && attr->getNamespaceURI().empty())
+                result.push_back(attr);
+        }
+        return;
+    }
+
+    if (step._axis == child_axis) {
+        for (XalanNode* n = node->getFirstChild(); n != 0; n = n->getNextSibling()) {
+            if (matches(n, step))
+                result.push_back(n);
+        }
+        return;
+    }
+
+    for (XalanNode* n = next_node(node, node); n != 0; n = next_node(n, node)) {
+        if (matches(n, step))
+            result.push_back(n);
+    }
+}
+
+//---------------------------------------------------------------
+bool simple_path::matches(const XalanNode* node, const step_t& step) {
+    const XalanNode::NodeType type = node->getNodeType();
+    switch (step._test) {
+    case element_test:
+        return type == XalanNode::ELEMENT_NODE
+                && node->getNodeName() == step._name
+                && node->getNamespaceURI().empty();
+    case any_element_test:
+        return type == XalanNode::ELEMENT_NODE;
+    case text_test:
+        return type == XalanNode::TEXT_NODE || type == XalanNode::CDATA_SECTION_NODE;
+    default:
+        return false;
+    }
+}
+
+//---------------------------------------------------------------
+bool simple_path::nested(const node_list_t& nodes) {
+    const boost::unordered_set<const XalanNode*> members(nodes.begin(), nodes.end());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        for (const XalanNode* p = nodes[i]->getParentNode(); p != 0; p = p->getParentNode()) {
+            if (members.count(p))
+                return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,488 @@
+/* 
+ * File:   snapshot.cpp
+ * Author: ycherkasov
+ *
+ * Created on 22 Октябрь 2026 г., 11:30
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <errno.h>
+#include <sys/stat.h>
+#include <boost/unordered_map.hpp>
+
+#include "xmlutils/snapshot.h"
+#include "xmlutils/dom_document.h"
+#include "xmlutils/dom_serializer.h"
+#include "xmlutils/xmlstring.h"
+#include "xmlutils/stats.h"
+
+using namespace xerces;
+
+// All fields are 32 or 64 bit in host byte order,
+// tables follow the header: nodes, links, strings
+struct snapshot::header_t {
+    char _magic[8];
+    boost::uint32_t _version;
+    boost::uint32_t _byte_order;
+    boost::uint64_t _source_size;
+    boost::int64_t _source_mtime;
+    boost::uint32_t _source_mtime_nsec;
+    boost::uint32_t _node_count;
+    boost::uint32_t _link_count;
+    boost::uint32_t _string_bytes;
+    /** @brief FNV-1a of the tables */
+    boost::uint32_t _checksum;
+};
+
+struct snapshot::node_record_t {
+    boost::uint32_t _kind;
+    boost::uint32_t _parent;
+    boost::uint32_t _name;
+    boost::uint32_t _value;
+    /** @brief First attribute and child in the link table */
+    boost::uint32_t _attributes;
+    boost::uint32_t _attribute_count;
+    boost::uint32_t _children;
+    boost::uint32_t _child_count;
+};
+
+namespace {
+
+const char magic[8] = { 'X', 'M', 'L', 'S', 'N', 'A', 'P', 0 };
+const boost::uint32_t byte_order = 0x01020304;
+
+std::string system_error(const char* what, const std::string& name, int error) {
+    return std::string(what) + " " + name + ": " + std::strerror(error);
+}
+
+boost::uint32_t checksum(const char* data, size_t size) {
+    boost::uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Size and modification time of the source file, nanoseconds
+// tell rewrites within the same second
+struct source_stamp {
+    source_stamp()
+    : _size(0)
+    , _mtime(0)
+    , _mtime_nsec(0) { }
+
+    explicit source_stamp(const char* filename) {
+        struct stat st;
+        if (::stat(filename, &st) != 0)
+            throw std::runtime_error(system_error("Unable to stat", filename, errno));
+        _size = static_cast<boost::uint64_t>(st.st_size);
+        _mtime = static_cast<boost::int64_t>(st.st_mtime);
+        _mtime_nsec = static_cast<boost::uint32_t>(st.st_mtim.tv_nsec);
+    }
+
+    boost::uint64_t _size;
+    boost::int64_t _mtime;
+    boost::uint32_t _mtime_nsec;
+};
+
+// Collects tables of the document, strings are stored once
+template <typename Header, typename Record>
+class snapshot_builder {
+public:
+    snapshot_builder()
+    : _strings(1, '\0') { }
+
+    void build(const DOMDocument* document) {
+        Record doc = Record();
+        doc._kind = snapshot::document_node;
+        _nodes.push_back(doc);
+        add_children(document, 0);
+    }
+
+    void write(const char* filename, const source_stamp& stamp) {
+        Header header = Header();
+        std::memcpy(header._magic, magic, sizeof(magic));
+        header._version = snapshot::format_version;
+        header._byte_order = byte_order;
+        header._source_size = stamp._size;
+        header._source_mtime = stamp._mtime;
+        header._source_mtime_nsec = stamp._mtime_nsec;
+        header._node_count = static_cast<boost::uint32_t>(_nodes.size());
+        header._link_count = static_cast<boost::uint32_t>(_links.size());
+        header._string_bytes = static_cast<boost::uint32_t>(_strings.size());
+
+        std::string image;
+        image.reserve(sizeof(Header) + size());
+        image.append(sizeof(Header), '\0');
+        append(image, &_nodes[0], _nodes.size());
+        if (!_links.empty())
+            append(image, &_links[0], _links.size());
+        image.append(_strings);
+        header._checksum = checksum(image.data() + sizeof(Header), image.size() - sizeof(Header));
+        std::memcpy(&image[0], &header, sizeof(Header));
+
+        // mappings of the previous snapshot keep its pages
+        dom_serializer::write_file(image, filename, true);
+    }
+
+    size_t size() const {
+        return _nodes.size() * sizeof(Record)
+                + _links.size() * sizeof(boost::uint32_t) + _strings.size();
+    }
+
+private:
+
+    template <typename T>
+    static void append(std::string& image, const T* data, size_t count) {
+        image.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+    }
+
+    boost::uint32_t add_string(const std::string& s) {
+        boost::unordered_map<std::string, boost::uint32_t>::iterator it = _offsets.find(s);
+        if (it != _offsets.end())
+            return it->second;
+        const boost::uint32_t offset = static_cast<boost::uint32_t>(_strings.size());
+        _strings.append(s.c_str(), s.size() + 1);
+        _offsets.insert(std::make_pair(s, offset));
+        return offset;
+    }
+
+    boost::uint32_t add_node(snapshot::kind_t kind, boost::uint32_t parent
+            , const XMLCh* name, const XMLCh* value) {
+        Record node = Record();
+        node._kind = kind;
+        node._parent = parent;
+        node._name = name ? add_string(xerces::string(name).get_utf8()) : 0;
+        node._value = value ? add_string(xerces::string(value).get_utf8()) : 0;
+        _nodes.push_back(node);
+        return static_cast<boost::uint32_t>(_nodes.size() - 1);
+    }
+
+    // Adds nodes in document order: element, its attributes, its children
+    void add_children(const DOMNode* parent_node, boost::uint32_t parent) {
+        std::vector<boost::uint32_t> children;
+        collect_children(parent_node, parent, children);
+        _nodes[parent]._children = static_cast<boost::uint32_t>(_links.size());
+        _nodes[parent]._child_count = static_cast<boost::uint32_t>(children.size());
+        _links.insert(_links.end(), children.begin(), children.end());
+    }
+
+    void collect_children(const DOMNode* parent_node, boost::uint32_t parent
+            , std::vector<boost::uint32_t>& children) {
+        for (const DOMNode* n = parent_node->getFirstChild(); n != 0; n = n->getNextSibling()) {
+            switch (n->getNodeType()) {
+            case DOMNode::ELEMENT_NODE:
+                children.push_back(add_element(n, parent));
+                break;
+            case DOMNode::TEXT_NODE:
+            case DOMNode::CDATA_SECTION_NODE:
+                children.push_back(add_node(snapshot::text_node, parent, 0, n->getNodeValue()));
+                break;
+            case DOMNode::ENTITY_REFERENCE_NODE:
+                // expanded content belongs to the parent
+                collect_children(n, parent, children);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    boost::uint32_t add_element(const DOMNode* element, boost::uint32_t parent) {
+        const boost::uint32_t node = add_node(snapshot::element_node, parent
+                , element->getNodeName(), 0);
+
+        std::vector<boost::uint32_t> attributes;
+        const DOMNamedNodeMap* const attrs = element->getAttributes();
+        const XMLSize_t count = attrs ? attrs->getLength() : 0;
+        for (XMLSize_t i = 0; i < count; ++i) {
+            const DOMNode* const attr = attrs->item(i);
+            const std::string name = xerces::string(attr->getNodeName()).get_utf8();
+            // namespace declarations are not XPath attributes
+            if (name.compare(0, 5, "xmlns") == 0 && (name.size() == 5 || name[5] == ':'))
+                continue;
+            attributes.push_back(add_node(snapshot::attribute_node, node
+                    , attr->getNodeName(), attr->getNodeValue()));
+        }
+        _nodes[node]._attributes = static_cast<boost::uint32_t>(_links.size());
+        _nodes[node]._attribute_count = static_cast<boost::uint32_t>(attributes.size());
+        _links.insert(_links.end(), attributes.begin(), attributes.end());
+
+        add_children(element, node);
+        return node;
+    }
+
+    std::vector<Record> _nodes;
+    std::vector<boost::uint32_t> _links;
+    std::string _strings;
+    boost::unordered_map<std::string, boost::uint32_t> _offsets;
+};
+
+// Location step of a snapshot query
+struct query_step {
+    enum test_t { element_test, any_element_test, attribute_test, text_test };
+    test_t _test;
+    std::string _name;
+};
+
+std::vector<query_step> parse_query(const char* path) {
+    std::vector<query_step> steps;
+    const char* s = path;
+    if (*s != '/')
+        throw std::runtime_error(std::string("Not an absolute path: ") + path);
+
+    while (*s == '/' && s[1] != 0) {
+        ++s;
+        const char* end = s;
+        while (*end != 0 && *end != '/')
+            ++end;
+        const std::string step(s, end);
+
+        query_step q;
+        if (step == "*")
+            q._test = query_step::any_element_test;
+        else if (step == "text()")
+            q._test = query_step::text_test;
+        else if (step[0] == '@')
+            q._test = query_step::attribute_test;
+        else
+            q._test = query_step::element_test;
+        if (q._test == query_step::element_test || q._test == query_step::attribute_test) {
+            q._name = (q._test == query_step::attribute_test) ? step.substr(1) : step;
+            if (q._name.empty() || q._name.find_first_of("[]()*@:=<>|$\"' ") != std::string::npos)
+                throw std::runtime_error(std::string("Unsupported snapshot query: ") + path);
+        }
+        // attribute and text have no children
+        if (*end != 0 && (q._test == query_step::attribute_test || q._test == query_step::text_test))
+            throw std::runtime_error(std::string("Unsupported snapshot query: ") + path);
+
+        steps.push_back(q);
+        s = end;
+    }
+    if (*s != 0 && !(s == path && s[1] == 0))
+        throw std::runtime_error(std::string("Unsupported snapshot query: ") + path);
+    return steps;
+}
+
+}
+
+//---------------------------------------------------------------
+size_t snapshot::compile(const char* xml_filename, const char* filename) {
+    // stamp before parse, later changes make the snapshot stale
+    const source_stamp stamp(xml_filename);
+    dom_document document(xml_filename);
+    // parse errors are not thrown by the document
+    if (document.document() == 0)
+        throw std::runtime_error(std::string("Unable to parse ") + xml_filename);
+
+    snapshot_builder<header_t, node_record_t> builder;
+    builder.build(document.document());
+    builder.write(filename, stamp);
+    return sizeof(header_t) + builder.size();
+}
+
+//---------------------------------------------------------------
+size_t snapshot::compile(const DOMDocument* document, const char* filename
+        , const char* source/* = 0*/) {
+    if (document == 0)
+        throw std::runtime_error("No XML document to compile");
+    const source_stamp stamp = source ? source_stamp(source) : source_stamp();
+
+    snapshot_builder<header_t, node_record_t> builder;
+    builder.build(document);
+    builder.write(filename, stamp);
+    return sizeof(header_t) + builder.size();
+}
+
+//---------------------------------------------------------------
+snapshot::snapshot(const char* filename, const char* source/* = 0*/
+        , bool verify/* = true*/)
+: _header(0)
+, _nodes(0)
+, _links(0)
+, _strings(0) {
+    XMLUTILS_STATS_PHASE(parse_phase);
+    try {
+        _file.reset(new mapped_file(filename));
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error(std::string("Unable to map snapshot ") + filename + ": " + e.what());
+    }
+
+    const char* const data = reinterpret_cast<const char*>(_file->data());
+    const size_t size = _file->size();
+    const std::string name(filename);
+    if (size < sizeof(header_t))
+        throw std::runtime_error("Truncated snapshot " + name);
+
+    _header = reinterpret_cast<const header_t*>(data);
+    if (std::memcmp(_header->_magic, magic, sizeof(magic)) != 0)
+        throw std::runtime_error("Not a snapshot " + name);
+    if (_header->_version != format_version || _header->_byte_order != byte_order)
+        throw std::runtime_error("Unsupported snapshot version " + name);
+
+    const boost::uint64_t tables = static_cast<boost::uint64_t>(_header->_node_count) * sizeof(node_record_t)
+            + static_cast<boost::uint64_t>(_header->_link_count) * sizeof(boost::uint32_t)
+            + _header->_string_bytes;
+    if (_header->_node_count == 0 || _header->_string_bytes == 0
+            || tables != size - sizeof(header_t))
+        throw std::runtime_error("Truncated snapshot " + name);
+
+    _nodes = reinterpret_cast<const node_record_t*>(data + sizeof(header_t));
+    _links = reinterpret_cast<const boost::uint32_t*>(_nodes + _header->_node_count);
+    _strings = reinterpret_cast<const char*>(_links + _header->_link_count);
+    if (_strings[_header->_string_bytes - 1] != 0)
+        throw std::runtime_error("Corrupted snapshot " + name);
+
+    if (verify && checksum(data + sizeof(header_t), size - sizeof(header_t)) != _header->_checksum)
+        throw std::runtime_error("Corrupted snapshot " + name);
+
+    if (source != 0) {
+        const source_stamp stamp(source);
+        if (stamp._size != _header->_source_size || stamp._mtime != _header->_source_mtime
+                || stamp._mtime_nsec != _header->_source_mtime_nsec)
+            throw std::runtime_error("Stale snapshot " + name + " of " + source);
+    }
+    XMLUTILS_STATS_ADD(bytes_read, size);
+}
+
+//---------------------------------------------------------------
+snapshot::~snapshot() { }
+
+//---------------------------------------------------------------
+size_t snapshot::size() const {
+    return _header->_node_count;
+}
+
+//---------------------------------------------------------------
+const snapshot::node_record_t& snapshot::record(node_t node) const {
+    if (node >= _header->_node_count)
+        throw std::out_of_range("Snapshot node out of range");
+    return _nodes[node];
+}
+
+//---------------------------------------------------------------
+const char* snapshot::string_at(boost::uint32_t offset) const {
+    if (offset >= _header->_string_bytes)
+        throw std::out_of_range("Snapshot string out of range");
+    return _strings + offset;
+}
+
+//---------------------------------------------------------------
+snapshot::kind_t snapshot::kind(node_t node) const {
+    return static_cast<kind_t>(record(node)._kind);
+}
+
+//---------------------------------------------------------------
+const char* snapshot::name(node_t node) const {
+    return string_at(record(node)._name);
+}
+
+//---------------------------------------------------------------
+const char* snapshot::value(node_t node) const {
+    return string_at(record(node)._value);
+}
+
+//---------------------------------------------------------------
+snapshot::node_t snapshot::parent(node_t node) const {
+    return record(node)._parent;
+}
+
+//---------------------------------------------------------------
+size_t snapshot::children(node_t node) const {
+    return record(node)._child_count;
+}
+
+//---------------------------------------------------------------
+snapshot::node_t snapshot::child(node_t node, size_t i) const {
+    const node_record_t& r = record(node);
+    if (i >= r._child_count || r._children + i >= _header->_link_count)
+        throw std::out_of_range("Snapshot child out of range");
+    return _links[r._children + i];
+}
+
+//---------------------------------------------------------------
+size_t snapshot::attributes(node_t node) const {
+    return record(node)._attribute_count;
+}
+
+//---------------------------------------------------------------
+snapshot::node_t snapshot::attribute(node_t node, size_t i) const {
+    const node_record_t& r = record(node);
+    if (i >= r._attribute_count || r._attributes + i >= _header->_link_count)
+        throw std::out_of_range("Snapshot attribute out of range");
+    return _links[r._attributes + i];
+}
+
+//---------------------------------------------------------------
+std::string snapshot::string_value(node_t node) const {
+    const kind_t k = kind(node);
+    if (k == attribute_node || k == text_node)
+        return value(node);
+
+    std::string text;
+    append_text(node, text);
+    return text;
+}
+
+//---------------------------------------------------------------
+void snapshot::append_text(node_t node, std::string& text) const {
+    const size_t count = children(node);
+    for (size_t i = 0; i < count; ++i) {
+        const node_t c = child(node, i);
+        if (kind(c) == text_node)
+            text += value(c);
+        else
+            append_text(c, text);
+    }
+}
+
+//---------------------------------------------------------------
+void snapshot::select(const char* path, node_list_t& result) const {
+    const std::vector<query_step> steps = parse_query(path);
+
+    result.assign(1, 0);
+    node_list_t next;
+    for (size_t i = 0; i < steps.size() && !result.empty(); ++i) {
+        const query_step& step = steps[i];
+        next.clear();
+        for (size_t j = 0; j < result.size(); ++j) {
+            const node_t n = result[j];
+            if (step._test == query_step::attribute_test) {
+                const size_t count = attributes(n);
+                for (size_t a = 0; a < count; ++a) {
+                    const node_t attr = attribute(n, a);
+                    if (step._name == name(attr))
+                        next.push_back(attr);
+                }
+                continue;
+            }
+            const size_t count = children(n);
+            for (size_t c = 0; c < count; ++c) {
+                const node_t ch = child(n, c);
+                const kind_t k = kind(ch);
+                if ((step._test == query_step::text_test && k == text_node)
+                        || (step._test == query_step::any_element_test && k == element_node)
+                        || (step._test == query_step::element_test && k == element_node
+                            && step._name == name(ch)))
+                    next.push_back(ch);
+            }
+        }
+        result.swap(next);
+    }
+    XMLUTILS_STATS_ADD(nodes_returned, result.size());
+}
+
+//---------------------------------------------------------------
+std::vector<std::string> snapshot::evaluate(const char* path) const {
+    node_list_t nodes;
+    select(path, nodes);
+
+    std::vector<std::string> values;
+    values.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+        values.push_back(string_value(nodes[i]));
+    return values;
+}
@@ -0,0 +1,92 @@
+/* 
+ * File:   stats.cpp
+ * Author: ycherkasov
+ *
+ * Created on 19 Октябрь 2026 г., 17:05
+ */
+
+#include <cassert>
+#include <time.h>
+#include <boost/atomic.hpp>
+
+#include "xmlutils/stats.h"
+
+using namespace xerces;
+
+namespace {
+
+// zero-initialized before any dynamic initialization
+boost::atomic<boost::uint64_t> g_phase_ns[stats::phase_count];
+boost::atomic<boost::uint64_t> g_phase_calls[stats::phase_count];
+boost::atomic<boost::uint64_t> g_counters[stats::counter_count];
+
+const char* const phase_names[stats::phase_count] = {
+    "parse",
+    "compile",
+    "execute",
+    "transcode",
+    "serialize"
+};
+
+const char* const counter_names[stats::counter_count] = {
+    "documents_parsed",
+    "bytes_read",
+    "bytes_written",
+    "nodes_returned",
+    "transcode_calls"
+};
+
+}
+
+//---------------------------------------------------------------
+stats::snapshot_t stats::snapshot() {
+    snapshot_t s;
+    for (size_t i = 0; i < phase_count; ++i) {
+        s._phase_ns[i] = g_phase_ns[i].load(boost::memory_order_relaxed);
+        s._phase_calls[i] = g_phase_calls[i].load(boost::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < counter_count; ++i)
+        s._counters[i] = g_counters[i].load(boost::memory_order_relaxed);
+    return s;
+}
+
+//---------------------------------------------------------------
+void stats::reset() {
+    for (size_t i = 0; i < phase_count; ++i) {
+        g_phase_ns[i].store(0, boost::memory_order_relaxed);
+        g_phase_calls[i].store(0, boost::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < counter_count; ++i)
+        g_counters[i].store(0, boost::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------
+const char* stats::phase_name(size_t phase) {
+    assert(phase < phase_count);
+    return phase_names[phase];
+}
+
+//---------------------------------------------------------------
+const char* stats::counter_name(size_t counter) {
+    assert(counter < counter_count);
+    return counter_names[counter];
+}
+
+//---------------------------------------------------------------
+void stats::add(counter_t counter, boost::uint64_t value/* = 1*/) {
+    g_counters[counter].fetch_add(value, boost::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------
+void stats::add_time(phase_t phase, boost::uint64_t ns) {
+    g_phase_ns[phase].fetch_add(ns, boost::memory_order_relaxed);
+    g_phase_calls[phase].fetch_add(1, boost::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------
+boost::uint64_t stats::now() {
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<boost::uint64_t>(ts.tv_sec) * 1000000000u
+            + static_cast<boost::uint64_t>(ts.tv_nsec);
+}
@@ -0,0 +1,270 @@
+/* 
+ * File:   xmlstring.cpp
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 14:30
+ */
+
+#include <cstring>
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include "xmlutils/xmlstring.h"
+#include "xmlutils/stats.h"
+
+using namespace xerces;
+
+namespace {
+
+const XMLCh replacement_char = 0xFFFD;
+
+bool is_ascii(const char* s, size_t length) {
+    for (size_t i = 0; i < length; ++i)
+	if (static_cast<unsigned char>(s[i]) & 0x80)
+	    return false;
+    return true;
+}
+
+bool is_ascii(const XMLCh* s, size_t length) {
+    for (size_t i = 0; i < length; ++i)
+	if (s[i] & 0xFF80)
+	    return false;
+    return true;
+}
+
+}
+
+//---------------------------------------------------------------
+string::string(const char* s, encoding_t encoding/* = local_code_page*/
+	, MemoryManager* const manager/* = XMLPlatformUtils::fgMemoryManager*/)
+: _heap(0)
+, _data(0)
+, _length(0)
+, _manager(manager) {
+    if (s == 0)
+	return;
+
+    XMLUTILS_STATS_ADD(transcode_calls, 1);
+    const size_t length = std::strlen(s);
+    if (is_ascii(s, length)) {
+	assign_ascii(s, length);
+    }
+    else if (encoding == utf8) {
+	assign_utf8(s, length);
+    }
+    else {
+	_heap = XMLString::transcode(s, _manager);
+	_data = _heap;
+	_length = XMLString::stringLen(_heap);
+    }
+}
+
+//---------------------------------------------------------------
+string::string(XMLCh* s
+	, MemoryManager* const manager/* = XMLPlatformUtils::fgMemoryManager*/)
+: _heap(0)
+, _data(0)
+, _length(0)
+, _manager(manager) {
+    if (s)
+	assign(s, XMLString::stringLen(s));
+}
+
+//---------------------------------------------------------------
+string::string(const XMLCh* s
+	, MemoryManager* const manager/* = XMLPlatformUtils::fgMemoryManager*/)
+: _heap(0)
+, _data(0)
+, _length(0)
+, _manager(manager) {
+    if (s)
+	assign(s, XMLString::stringLen(s));
+}
+
+//---------------------------------------------------------------
+string::string(const string& s)
+: _heap(0)
+, _data(0)
+, _length(0)
+, _manager(s._manager) {
+    if (s._data)
+	assign(s._data, s._length);
+}
+
+//---------------------------------------------------------------
+string& string::operator=(const string& s) {
+    if (this == &s)
+	return *this;
+
+    release();
+    if (s._data)
+	assign(s._data, s._length);
+    return *this;
+}
+
+//---------------------------------------------------------------
+string::~string() {
+    release();
+}
+
+//---------------------------------------------------------------
+std::string string::get_string() const {
+    if (_data == 0)
+	return std::string();
+
+    XMLUTILS_STATS_ADD(transcode_calls, 1);
+
+    // 7-bit strings are the same in any code page
+    if (is_ascii(_data, _length))
+	return std::string(_data, _data + _length);
+
+    char* chstr = XMLString::transcode(_data, _manager);
+    std::string ret(chstr);
+    _manager->deallocate(chstr);
+    return ret;
+}
+
+//---------------------------------------------------------------
+std::string string::get_utf8() const {
+    std::string ret;
+    if (_data == 0)
+	return ret;
+
+    XMLUTILS_STATS_ADD(transcode_calls, 1);
+
+    ret.reserve(_length);
+    for (size_t i = 0; i < _length; ++i) {
+	unsigned long c = _data[i];
+
+	// surrogate pair
+	if (c >= 0xD800 && c <= 0xDBFF && i + 1 < _length
+		&& _data[i + 1] >= 0xDC00 && _data[i + 1] <= 0xDFFF) {
+	    c = 0x10000 + ((c - 0xD800) << 10) + (_data[i + 1] - 0xDC00);
+	    ++i;
+	}
+
+	if (c < 0x80) {
+	    ret += static_cast<char>(c);
+	}
+	else if (c < 0x800) {
+	    ret += static_cast<char>(0xC0 | (c >> 6));
+	    ret += static_cast<char>(0x80 | (c & 0x3F));
+	}
+	else if (c < 0x10000) {
+	    ret += static_cast<char>(0xE0 | (c >> 12));
+	    ret += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+	    ret += static_cast<char>(0x80 | (c & 0x3F));
+	}
+	else {
+	    ret += static_cast<char>(0xF0 | (c >> 18));
+	    ret += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+	    ret += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+	    ret += static_cast<char>(0x80 | (c & 0x3F));
+	}
+    }
+    return ret;
+}
+
+//---------------------------------------------------------------
+void string::assign(const XMLCh* s, size_t length) {
+    XMLCh* buffer = reserve(length);
+    std::memcpy(buffer, s, length * sizeof(XMLCh));
+    buffer[length] = 0;
+    _length = length;
+}
+
+//---------------------------------------------------------------
+void string::assign_ascii(const char* s, size_t length) {
+    XMLCh* buffer = reserve(length);
+    for (size_t i = 0; i < length; ++i)
+	buffer[i] = static_cast<XMLCh>(s[i]);
+    buffer[length] = 0;
+    _length = length;
+}
+
+//---------------------------------------------------------------
+void string::assign_utf8(const char* s, size_t length) {
+    // UTF-16 never takes more code units than UTF-8 bytes
+    XMLCh* buffer = reserve(length);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    const unsigned char* const end = p + length;
+    size_t n = 0;
+
+    while (p < end) {
+	unsigned long c = *p++;
+	size_t trail = 0;
+	if (c >= 0xF0 && c <= 0xF4) {
+	    trail = 3;
+	    c &= 0x07;
+	}
+	else if (c >= 0xE0 && c <= 0xEF) {
+	    trail = 2;
+	    c &= 0x0F;
+	}
+	else if (c >= 0xC2 && c <= 0xDF) {
+	    trail = 1;
+	    c &= 0x1F;
+	}
+	else if (c >= 0x80) {
+	    // stray continuation or invalid lead byte
+	    buffer[n++] = replacement_char;
+	    continue;
+	}
+
+	if (static_cast<size_t>(end - p) < trail) {
+	    buffer[n++] = replacement_char;
+	    break;
+	}
+
+	bool valid = true;
+	for (size_t i = 0; i < trail; ++i) {
+	    if ((p[i] & 0xC0) != 0x80) {
+		valid = false;
+		break;
+	    }
+	    c = (c << 6) | (p[i] & 0x3F);
+	}
+
+	// overlong forms and surrogates are invalid
+	if (!valid || (trail == 2 && (c < 0x800 || (c >= 0xD800 && c <= 0xDFFF)))
+		|| (trail == 3 && (c < 0x10000 || c > 0x10FFFF))) {
+	    buffer[n++] = replacement_char;
+	    continue;
+	}
+	p += trail;
+
+	if (c >= 0x10000) {
+	    c -= 0x10000;
+	    buffer[n++] = static_cast<XMLCh>(0xD800 + (c >> 10));
+	    buffer[n++] = static_cast<XMLCh>(0xDC00 + (c & 0x3FF));
+	}
+	else {
+	    buffer[n++] = static_cast<XMLCh>(c);
+	}
+    }
+
+    buffer[n] = 0;
+    _length = n;
+}
+
+//---------------------------------------------------------------
+XMLCh* string::reserve(size_t length) {
+    release();
+    if (length < inline_capacity) {
+	_data = _inline;
+	return _inline;
+    }
+
+    _heap = static_cast<XMLCh*>(_manager->allocate((length + 1) * sizeof(XMLCh)));
+    _data = _heap;
+    return _heap;
+}
+
+//---------------------------------------------------------------
+void string::release() {
+    // transcoded and own buffers come from the same memory manager
+    if (_heap)
+	_manager->deallocate(_heap);
+    _heap = 0;
+    _data = 0;
+    _length = 0;
+}
@@ -7,6 +7,7 @@
 
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -26,6 +27,9 @@
 
 #include "xmlutils/xpath.h"
 #include "xmlutils/xmlstring.h"
+#include "xmlutils/counted_input_source.h"
+#include "xmlutils/mapped_file.h"
+#include "xmlutils/stats.h"
 
 
 XALAN_USING_STD(cerr)
@@ -34,49 +38,306 @@ XALAN_USING_STD(ostream)
 
 using namespace xerces;
 
-xpath::xpath(const std::string& filename)
-: _xpath_wrapper()
+namespace {
+
+MemoryManager& select_manager(arena_memory_manager* arena) {
+    if (arena)
+        return *arena;
+    return *XMLPlatformUtils::fgMemoryManager;
+}
+
+}
+
+xpath::xpath(memory_policy policy/* = default_memory_policy*/)
+: _platform(platform::xpath_component)
+, _input_size(0)
+, _arena(policy == arena_memory ? new arena_memory_manager : 0)
+, _helper(0, select_manager(_arena.get()))
+, _document(0)
+, _source(0)
+, _source_revision(0)
+, _native(true)
+, _cache(_helper._xpath_factory) { }
+
+xpath::xpath(const std::string& filename
+        , memory_policy policy/* = default_memory_policy*/)
+: _platform(platform::xpath_component)
 , _filename(filename.c_str())
-, _input_source(_filename.c_str()) { }
+, _input_source(new counted_input_source(new LocalFileInputSource(_filename.c_str())))
+, _input_size(0)
+, _arena(policy == arena_memory ? new arena_memory_manager : 0)
+, _helper(0, select_manager(_arena.get()))
+, _document(0)
+, _source(0)
+, _source_revision(0)
+, _native(true)
+, _cache(_helper._xpath_factory) {
+    reload();
+}
+
+xpath::xpath(const std::string& filename, const projection& patterns
+        , memory_policy policy/* = default_memory_policy*/)
+: _platform(platform::xpath_component)
+, _filename(filename.c_str())
+, _input_source(new counted_input_source(new LocalFileInputSource(_filename.c_str())))
+, _input_size(0)
+, _projection(new projection(patterns))
+, _arena(policy == arena_memory ? new arena_memory_manager : 0)
+, _helper(0, select_manager(_arena.get()))
+, _document(0)
+, _source(0)
+, _source_revision(0)
+, _native(true)
+, _cache(_helper._xpath_factory) {
+    reload();
+}
+
+xpath::xpath(const XMLByte* data, size_t size
+        , memory_policy policy/* = default_memory_policy*/)
+: _platform(platform::xpath_component)
+, _input_source(new MemBufInputSource(data
+        , buffer_size(size)
+        , "xpath buffer"
+        , false))
+, _input_size(size)
+, _arena(policy == arena_memory ? new arena_memory_manager : 0)
+, _helper(0, select_manager(_arena.get()))
+, _document(0)
+, _source(0)
+, _source_revision(0)
+, _native(true)
+, _cache(_helper._xpath_factory) {
+    reload();
+}
+
+xpath::xpath(dom_document& document)
+: _platform(platform::xpath_component)
+, _input_size(0)
+, _helper(0, *XMLPlatformUtils::fgMemoryManager, true)
+, _document(0)
+, _source(&document)
+, _source_revision(0)
+, _native(true)
+, _cache(_helper._xpath_factory) {
+    reload();
+}
 
 xpath::~xpath() { }
 
-void xpath::evaluate(const char* expr, const char* context)
+void xpath::open(const std::string& filename)
+{
+    if (_arena && _document != 0)
+        throw std::logic_error("Arena memory evaluator can't parse another document");
+
+    _filename = filename.c_str();
+    _input_source.reset(new counted_input_source(new LocalFileInputSource(_filename.c_str())));
+    _input_size = 0;
+    _source = 0;
+    reload();
+}
+
+void xpath::set_projection(const projection* patterns)
+{
+    _projection.reset(patterns ? new projection(*patterns) : 0);
+}
+
+void xpath::reload()
+{
+    // arena memory of the previous document is never reused
+    if (_arena && _document != 0)
+        throw std::logic_error("Arena memory evaluator can't parse another document");
+
+    // result nodes belong to the document
+    _result.clear();
+    if (_path_index)
+        _path_index->clear();
+
+    if (_document != 0) {
+        _helper.destroy(_document);
+        _document = 0;
+    }
+
+    // live document is wrapped, not parsed
+    if (_source != 0) {
+        if (_source->document() == 0)
+            throw std::runtime_error("No XML document opened");
+        _document = _helper.wrap(_source->document());
+        _source_revision = _source->revision();
+        assert(_document != 0);
+        if (_path_index)
+            _path_index->build(_document);
+        return;
+    }
+
+    if (!_input_source)
+        throw std::runtime_error("No XML document to parse");
+
+    XMLUTILS_STATS_PHASE(parse_phase);
+    _document = _helper.parse(*_input_source, _projection.get());
+    XMLUTILS_STATS_ADD(documents_parsed, 1);
+    // file bytes are counted by its input source
+    XMLUTILS_STATS_ADD(bytes_read, _input_size);
+    assert(_document != 0);
+    if (_path_index)
+        _path_index->build(_document);
+}
+
+void xpath::enable_path_index(bool enable/* = true*/)
+{
+    if (!enable) {
+        _path_index.reset();
+        return;
+    }
+    if (!_path_index)
+        _path_index.reset(new path_index);
+    _path_index->build(_document);
+}
+
+bool xpath::evaluate_indexed(const char* expr, const char* context
+        , xpath_result& result)
+{
+    if (!_path_index || std::strcmp(context, "/") != 0 || !path_index::indexable(expr))
+        return false;
+
+    XMLUTILS_STATS_PHASE(execute_phase);
+
+    // absolute path without matches is an empty nodeset
+    assign_nodes(_path_index->find(expr), result);
+    XMLUTILS_STATS_ADD(nodes_returned, result.size());
+    return true;
+}
+
+bool xpath::evaluate_native(const char* expr, const char* context
+        , xpath_result& result)
+{
+    if (!_native)
+        return false;
+
+    simple_path context_path;
+    simple_path expr_path;
+    if (!context_path.parse(context) || !expr_path.parse(expr))
+        return false;
+
+    XMLUTILS_STATS_PHASE(execute_phase);
+
+    // the same steps as Xalan evaluation below
+    simple_path::node_list_t nodes;
+    if (!context_path.evaluate(_document->getDocumentElement(), nodes))
+        return false;
+
+    if (nodes.empty()) {
+        std::ostringstream err;
+        err << "Emplty nodeset in context " << context;
+        throw std::runtime_error(err.str().c_str());
+    }
+    if (nodes.size() == 1) {
+        XalanNode* const context_node = nodes[0];
+        if (!expr_path.evaluate(context_node, nodes))
+            return false;
+    }
+
+    assign_nodes(&nodes, result);
+    XMLUTILS_STATS_ADD(nodes_returned, result.size());
+    return true;
+}
+
+void xpath::assign_nodes(const std::vector<XalanNode*>* nodes
+        , xpath_result& result)
+{
+    XPathExecutionContext::BorrowReturnMutableNodeRefList list(_helper._exec_context);
+    if (nodes != 0) {
+        for (size_t i = 0; i < nodes->size(); ++i)
+            list->addNode((*nodes)[i]);
+    }
+    result.assign(_helper._xobject_factory.createNodeSet(list));
+}
+
+void xpath::enable_native(bool enable/* = true*/)
+{
+    _native = enable;
+}
+
+const xpath_cache::entry_t& xpath::compile(const char* expr, const char* context)
+{
+    const std::string key_context(context);
+    const std::string key_expr(expr);
+
+    const xpath_cache::entry_t* cached = _cache.find(key_context, key_expr);
+    if (cached != 0)
+        return *cached;
+
+    XMLUTILS_STATS_PHASE(compile_phase);
+    XPath * const compiled_context = _helper.compile(XalanDOMString(context));
+    XPath * compiled_expr = 0;
+    try {
+        compiled_expr = _helper.compile(XalanDOMString(expr));
+    }
+    catch (...) {
+        _helper._xpath_factory.returnObject(compiled_context);
+        throw;
+    }
+    return _cache.insert(key_context, key_expr, compiled_context, compiled_expr);
+}
+
+const xpath_result& xpath::evaluate(const char* expr, const char* context)
+{
+    evaluate_to(expr, context, _result);
+    return _result;
+}
+
+xpath::batch_result_t xpath::evaluate_batch(const std::vector<query_t>& queries)
+{
+    batch_result_t results(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        evaluate_to(queries[i].first.c_str()
+                , queries[i].second.c_str()
+                , _result);
+        results[i] = _result.strings();
+    }
+    return results;
+}
+
+void xpath::evaluate_to(const char* expr, const char* context
+        , xpath_result& result)
 {
 
     // Just hoist everything...
     XALAN_CPP_NAMESPACE_USE
     XALAN_USING_XERCES(XMLException);
-    XALAN_USING_XERCES(LocalFileInputSource);
-    typedef XPathConstructionContext::GetAndReleaseCachedString GetAndReleaseCachedString;
 
-    // Create XPath execution context
-    XalanElement* rootElem = 0;
-    helper_t xpath_helper(rootElem);
+    result.clear();
 
+    if (_document == 0)
+        throw std::runtime_error("No XML document opened");
 
-    // configure the objects needed for XPath to work with the Xerces DOM
-    XalanDocument * const doc = xpath_helper._liason_wrapper.parseXMLStream(_input_source);
-    assert(doc != 0);
+    // wrapper doesn't follow changes of the live document
+    if (_source != 0 && _source->revision() != _source_revision)
+        reload();
 
-    rootElem = doc->getDocumentElement();
+    if (evaluate_indexed(expr, context, result))
+        return;
+    if (evaluate_native(expr, context, result))
+        return;
+
+    XalanElement* const rootElem = _document->getDocumentElement();
     assert(rootElem != 0);
 
-    // first get the context nodeset
-    XalanDOMString xpath_context(context);
-    xpath_helper.init(xpath_context);
+    // compile the context and the expression once per cache lifetime
+    const xpath_cache::entry_t& compiled = compile(expr, context);
 
-    XObjectPtr xObj = xpath_helper._xpath_context->execute(rootElem
-            , xpath_helper._prefix_resolver
-            , xpath_helper._exec_context);
+    XMLUTILS_STATS_PHASE(execute_phase);
+
+    // first get the context nodeset
+    XObjectPtr xObj = compiled._context->execute(rootElem
+            , _helper._prefix_resolver
+            , _helper._exec_context);
 
     const NodeRefListBase& contextNodeList = xObj->nodeset();
     const unsigned int theLength = contextNodeList.getLength();
 
     if (theLength == 0) {
         std::ostringstream err;
-        xerces::string x(xpath_context.c_str());
-        err << "Emplty nodeset in context " << x.get_string();
+        err << "Emplty nodeset in context " << context;
         throw std::runtime_error(err.str().c_str());
     }
     if (theLength > 1) {
@@ -84,48 +345,14 @@ void xpath::evaluate(const char* expr, const char* context)
     }
     else {
         // and now get the result of the primary xpath expression
-        XPath * const xpath = xpath_helper._xpath_factory.create();
-
-        xpath_context = expr;
-        xpath_helper._xpath_processor.initXPath(*xpath,
-                xpath_helper._construction_context,
-                xpath_context,
-                xpath_helper._prefix_resolver);
-
-        xObj = xpath->execute(contextNodeList.item(0),
-                xpath_helper._prefix_resolver,
-                xpath_helper._exec_context);
+        xObj = compiled._expression->execute(contextNodeList.item(0),
+                _helper._prefix_resolver,
+                _helper._exec_context);
     }
 
-    // now encode the results.  For all types but nodelist, 
-    // we'll just convert it to a string, but, for nodelist,
-    // we'll convert each node to a string and return a list of them
-    XObject::eObjectType type = xObj->getType();
-    if (xObj->getType() == XObject::eTypeNodeSet) {
-        const NodeRefListBase& nodeset = xObj->nodeset();
-        size_t len = nodeset.getLength();
-
-        for (size_t i = 0; i < len; i++) {
-            XalanNode * const node = nodeset.item(i);
-            XalanDOMString str;
-
-            const int theType = node->getNodeType();
-
-            if (theType == XalanNode::COMMENT_NODE ||
-                    theType == XalanNode::PROCESSING_INSTRUCTION_NODE)
-                str = node->getNodeValue();
-            else if (theType == XalanNode::ELEMENT_NODE)
-                str = node->getNodeName();
-            else
-                DOMServices::getNodeData(*node, str);
-            xerces::string res_string(str.c_str());
-            _result.push_back(res_string.get_string());
-        }
-    }
-    else {
-        xerces::string res_string(xObj->str().c_str());
-        _result.push_back(res_string.get_string());
-    }
+    // keep the result object, values are converted on demand
+    result.assign(xObj);
+    XMLUTILS_STATS_ADD(nodes_returned, result.size());
 }
 
 #if 0
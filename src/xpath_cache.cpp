@@ -0,0 +1,75 @@
+/* 
+ * File:   xpath_cache.cpp
+ * Author: ycherkasov
+ *
+ * Created on 17 Октябрь 2026 г., 11:20
+ */
+
+#include "xmlutils/xpath_cache.h"
+
+using namespace xerces;
+
+//---------------------------------------------------------------
+xpath_cache::xpath_cache(XPathFactory& factory, size_t capacity/* = default_capacity*/)
+: _factory(factory)
+, _capacity(capacity ? capacity : 1)
+, _hits(0)
+, _misses(0) { }
+
+//---------------------------------------------------------------
+xpath_cache::~xpath_cache() {
+    clear();
+}
+
+//---------------------------------------------------------------
+const xpath_cache::entry_t* xpath_cache::find(const std::string& context
+        , const std::string& expr) {
+
+    index_t::iterator it = _index.find(key_t(context, expr));
+    if (it == _index.end()) {
+        ++_misses;
+        return 0;
+    }
+
+    ++_hits;
+    // move to the head of LRU list, iterators stay valid
+    _lru.splice(_lru.begin(), _lru, it->second);
+    return &it->second->second;
+}
+
+//---------------------------------------------------------------
+const xpath_cache::entry_t& xpath_cache::insert(const std::string& context
+        , const std::string& expr
+        , XPath* compiled_context
+        , XPath* compiled_expr) {
+
+    shrink(_capacity - 1);
+
+    entry_t entry = { compiled_context, compiled_expr };
+    const key_t key(context, expr);
+    _lru.push_front(std::make_pair(key, entry));
+    _index[key] = _lru.begin();
+    return _lru.front().second;
+}
+
+//---------------------------------------------------------------
+void xpath_cache::clear() {
+    shrink(0);
+}
+
+//---------------------------------------------------------------
+void xpath_cache::set_capacity(size_t capacity) {
+    _capacity = capacity ? capacity : 1;
+    shrink(_capacity);
+}
+
+//---------------------------------------------------------------
+void xpath_cache::shrink(size_t capacity) {
+    while (_index.size() > capacity) {
+        const entry_t& entry = _lru.back().second;
+        _factory.returnObject(entry._context);
+        _factory.returnObject(entry._expression);
+        _index.erase(_lru.back().first);
+        _lru.pop_back();
+    }
+}
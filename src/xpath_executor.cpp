@@ -0,0 +1,121 @@
+/* 
+ * File:   xpath_executor.cpp
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 11:20
+ */
+
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "xmlutils/xpath_executor.h"
+#include "xmlutils/error_message.h"
+
+using namespace xerces;
+
+//---------------------------------------------------------------
+xpath_executor::xpath_executor(size_t threads/* = 0*/) {
+    if (threads == 0)
+        threads = boost::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+
+    _workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i)
+        _workers.push_back(boost::shared_ptr<worker_t>(new worker_t));
+}
+
+//---------------------------------------------------------------
+xpath_executor::~xpath_executor() { }
+
+//---------------------------------------------------------------
+xpath_executor::result_t xpath_executor::run(const std::vector<std::string>& files
+        , const std::vector<xpath::query_t>& queries) {
+
+    result_t results(files.size());
+
+    // split files in contiguous chunks, neighbours are stolen from the tail
+    const size_t count = _workers.size();
+    const size_t chunk = (files.size() + count - 1) / count;
+    for (size_t i = 0; i < count; ++i) {
+        worker_t& w = *_workers[i];
+        w._queue.clear();
+        w._stolen = 0;
+        for (size_t f = i * chunk; f < files.size() && f < (i + 1) * chunk; ++f)
+            w._queue.push_back(f);
+    }
+
+    // a single worker doesn't need a thread
+    if (count == 1) {
+        work(0, files, queries, results);
+        return results;
+    }
+
+    boost::thread_group group;
+    for (size_t i = 0; i < count; ++i) {
+        group.create_thread(boost::bind(&xpath_executor::work, this, i
+                , boost::cref(files), boost::cref(queries), boost::ref(results)));
+    }
+    group.join_all();
+    return results;
+}
+
+//---------------------------------------------------------------
+size_t xpath_executor::stolen() const {
+    size_t total = 0;
+    for (size_t i = 0; i < _workers.size(); ++i)
+        total += _workers[i]->_stolen;
+    return total;
+}
+
+//---------------------------------------------------------------
+void xpath_executor::work(size_t id
+        , const std::vector<std::string>& files
+        , const std::vector<xpath::query_t>& queries
+        , result_t& results) {
+
+    xpath& evaluator = _workers[id]->_evaluator;
+
+    // every index is taken by one worker only, results need no lock
+    size_t index = 0;
+    while (next(id, index)) {
+        file_result_t& res = results[index];
+        res._filename = files[index];
+        try {
+            evaluator.open(files[index]);
+            res._results = evaluator.evaluate_batch(queries);
+        }
+        catch (...) {
+            res._error = current_error_message();
+        }
+    }
+}
+
+//---------------------------------------------------------------
+bool xpath_executor::next(size_t id, size_t& index) {
+    {
+        worker_t& own = *_workers[id];
+        boost::mutex::scoped_lock lock(own._mutex);
+        if (!own._queue.empty()) {
+            index = own._queue.front();
+            own._queue.pop_front();
+            return true;
+        }
+    }
+
+    // no files are added during the run, so one pass over victims is enough
+    const size_t count = _workers.size();
+    for (size_t i = 1; i < count; ++i) {
+        worker_t& victim = *_workers[(id + i) % count];
+        boost::mutex::scoped_lock lock(victim._mutex);
+        if (!victim._queue.empty()) {
+            index = victim._queue.back();
+            victim._queue.pop_back();
+            ++_workers[id]->_stolen;
+            return true;
+        }
+    }
+    return false;
+}
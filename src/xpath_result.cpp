@@ -0,0 +1,202 @@
+/* 
+ * File:   xpath_result.cpp
+ * Author: ycherkasov
+ *
+ * Created on 17 Октябрь 2026 г., 13:05
+ */
+
+#include <limits>
+#include <xalanc/XPath/NodeRefListBase.hpp>
+#include <xalanc/DOMSupport/DOMServices.hpp>
+
+#include "xmlutils/xpath_result.h"
+#include "xmlutils/xmlstring.h"
+#include "xmlutils/stats.h"
+
+using namespace xerces;
+
+namespace {
+
+bool is_space(XalanDOMChar c) {
+    return c == 0x20 || c == 0x09 || c == 0x0A || c == 0x0D;
+}
+
+}
+
+//---------------------------------------------------------------
+xpath_result::xpath_result()
+: _transcoded(false) { }
+
+//---------------------------------------------------------------
+void xpath_result::assign(const XObjectPtr& obj) {
+    _object = obj;
+    _strings.clear();
+    _transcoded = false;
+}
+
+//---------------------------------------------------------------
+void xpath_result::clear() {
+    assign(XObjectPtr());
+}
+
+//---------------------------------------------------------------
+bool xpath_result::is_nodeset() const {
+    return !_object.null() && _object->getType() == XObject::eTypeNodeSet;
+}
+
+//---------------------------------------------------------------
+size_t xpath_result::size() const {
+    if (_object.null())
+        return 0;
+    if (is_nodeset())
+        return _object->nodeset().getLength();
+    return 1;
+}
+
+//---------------------------------------------------------------
+XalanNode* xpath_result::node(size_t i) const {
+    if (!is_nodeset())
+        return 0;
+    return _object->nodeset().item(i);
+}
+
+//---------------------------------------------------------------
+double xpath_result::number() const {
+    if (_object.null())
+        return 0;
+    return _object->num();
+}
+
+//---------------------------------------------------------------
+bool xpath_result::boolean() const {
+    if (_object.null())
+        return false;
+    return _object->boolean();
+}
+
+//---------------------------------------------------------------
+const XalanDOMString& xpath_result::value(size_t i/* = 0*/) const {
+    _value.clear();
+    if (_object.null())
+        return _value;
+
+    if (!is_nodeset())
+        return _object->str();
+
+    XalanNode * const node = _object->nodeset().item(i);
+    const int theType = node->getNodeType();
+
+    if (theType == XalanNode::COMMENT_NODE ||
+            theType == XalanNode::PROCESSING_INSTRUCTION_NODE)
+        return node->getNodeValue();
+    else if (theType == XalanNode::ELEMENT_NODE)
+        return node->getNodeName();
+
+    DOMServices::getNodeData(*node, _value);
+    return _value;
+}
+
+//---------------------------------------------------------------
+bool xpath_result::to_integer(long& v, size_t i/* = 0*/) const {
+    if (size() <= i)
+        return false;
+
+    const XalanDOMChar* s = value(i).c_str();
+    while (is_space(*s))
+        ++s;
+
+    const bool negative = (*s == XalanDOMChar('-'));
+    if (negative || *s == XalanDOMChar('+'))
+        ++s;
+
+    unsigned long u = 0;
+    if (!parse_unsigned(s, u))
+        return false;
+
+    const unsigned long limit = static_cast<unsigned long>(std::numeric_limits<long>::max());
+    if (negative) {
+        if (u > limit + 1)
+            return false;
+        v = (u == limit + 1) ? std::numeric_limits<long>::min() : -static_cast<long>(u);
+    }
+    else {
+        if (u > limit)
+            return false;
+        v = static_cast<long>(u);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------
+bool xpath_result::to_unsigned(unsigned long& v, size_t i/* = 0*/) const {
+    if (size() <= i)
+        return false;
+
+    const XalanDOMChar* s = value(i).c_str();
+    while (is_space(*s))
+        ++s;
+    if (*s == XalanDOMChar('+'))
+        ++s;
+    return parse_unsigned(s, v);
+}
+
+//---------------------------------------------------------------
+const std::string& xpath_result::string(size_t i/* = 0*/) const {
+    return strings().at(i);
+}
+
+//---------------------------------------------------------------
+const std::vector<std::string>& xpath_result::strings() const {
+    if (_transcoded)
+        return _strings;
+
+    XMLUTILS_STATS_PHASE(transcode_phase);
+    const size_t len = size();
+    _strings.clear();
+    _strings.reserve(len);
+    for (size_t i = 0; i < len; i++) {
+        xerces::string res_string(value(i).c_str());
+        _strings.push_back(res_string.get_string());
+    }
+    _transcoded = true;
+    return _strings;
+}
+
+//---------------------------------------------------------------
+bool xpath_result::parse_unsigned(const XalanDOMChar* s, unsigned long& v) {
+    unsigned long base = 10;
+    if (s[0] == XalanDOMChar('0') && (s[1] == XalanDOMChar('x') || s[1] == XalanDOMChar('X'))) {
+        base = 16;
+        s += 2;
+    }
+
+    unsigned long u = 0;
+    const XalanDOMChar* const first = s;
+    for (; *s; ++s) {
+        unsigned long digit = 0;
+        if (*s >= XalanDOMChar('0') && *s <= XalanDOMChar('9'))
+            digit = *s - XalanDOMChar('0');
+        else if (base == 16 && *s >= XalanDOMChar('a') && *s <= XalanDOMChar('f'))
+            digit = *s - XalanDOMChar('a') + 10;
+        else if (base == 16 && *s >= XalanDOMChar('A') && *s <= XalanDOMChar('F'))
+            digit = *s - XalanDOMChar('A') + 10;
+        else
+            break;
+
+        if (u > (std::numeric_limits<unsigned long>::max() - digit) / base)
+            return false;
+        u = u * base + digit;
+    }
+
+    if (s == first)
+        return false;
+
+    // trailing spaces only
+    while (is_space(*s))
+        ++s;
+    if (*s)
+        return false;
+
+    v = u;
+    return true;
+}
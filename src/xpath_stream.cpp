@@ -0,0 +1,349 @@
+/* 
+ * File:   xpath_stream.cpp
+ * Author: ycherkasov
+ *
+ * Created on 18 Октябрь 2026 г., 10:15
+ */
+
+#include <algorithm>
+#include <deque>
+#include <sstream>
+#include <stdexcept>
+#include <boost/scoped_ptr.hpp>
+#include <xercesc/framework/XMLPScanToken.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include "xmlutils/xpath_stream.h"
+
+using namespace xerces;
+
+namespace {
+
+typedef xpath_stream::xstring_t xstring_t;
+
+xstring_t to_xstring(const std::string& s) {
+    xerces::string x(s.c_str());
+    return xstring_t(x.get_wchar());
+}
+
+void unsupported(const std::string& expr) {
+    std::ostringstream err;
+    err << "Unsupported streaming XPath expression " << expr;
+    throw std::runtime_error(err.str().c_str());
+}
+
+/** @brief SAX2 handler matching location steps against open elements.
+ * For every open element it keeps indexes of steps which can match its
+ * children, so memory depends on the document depth only. */
+class stream_handler : public DefaultHandler {
+public:
+
+    stream_handler(const std::vector<xpath_stream::step_t>& steps
+            , const xstring_t& attribute
+            , xpath_stream::handler_t& handler)
+    : _steps(steps)
+    , _attribute(attribute)
+    , _handler(handler)
+    , _depth(0)
+    , _matches(0)
+    , _stopped(false) {
+        // document node looks for the first step
+        _states.resize(1);
+        _states[0].push_back(0);
+    }
+
+    virtual void startElement(const XMLCh* const uri
+            , const XMLCh* const localname
+            , const XMLCh* const qname
+            , const Attributes& attrs) {
+
+        if (_stopped)
+            return;
+
+        ++_depth;
+        if (_states.size() <= _depth)
+            _states.resize(_depth + 1);
+
+        const std::vector<size_t>& parent = _states[_depth - 1];
+        std::vector<size_t>& current = _states[_depth];
+        current.clear();
+
+        bool matched = false;
+        for (size_t i = 0; i < parent.size(); ++i) {
+            const size_t s = parent[i];
+            const xpath_stream::step_t& step = _steps[s];
+
+            // descendant step may match deeper too
+            if (step._descendant)
+                add_state(current, s);
+
+            if (!match(step, qname, attrs))
+                continue;
+
+            if (s + 1 == _steps.size())
+                matched = true;
+            else
+                add_state(current, s + 1);
+        }
+
+        if (!matched)
+            return;
+
+        if (_attribute.empty()) {
+            // slot is taken in document order, text is emitted on element end
+            _captures.push_back(capture_t());
+            _captures.back()._depth = _depth;
+            _captures.back()._open = true;
+        }
+        else {
+            const XMLCh* value = attrs.getValue(_attribute.c_str());
+            if (value)
+                emit(value);
+        }
+    }
+
+    virtual void endElement(const XMLCh* const uri
+            , const XMLCh* const localname
+            , const XMLCh* const qname) {
+
+        if (_stopped)
+            return;
+
+        // open captures are nested, so the innermost one is the last
+        for (std::deque<capture_t>::reverse_iterator it = _captures.rbegin();
+                it != _captures.rend(); ++it) {
+            if (!it->_open)
+                continue;
+            if (it->_depth == _depth)
+                it->_open = false;
+            break;
+        }
+
+        // nested match waits for the enclosing one
+        while (!_stopped && !_captures.empty() && !_captures.front()._open) {
+            const xstring_t text(_captures.front()._text);
+            _captures.pop_front();
+            emit(text.c_str());
+        }
+        --_depth;
+    }
+
+    virtual void characters(const XMLCh* const chars
+            , const unsigned int length) {
+
+        for (size_t i = 0; i < _captures.size(); ++i) {
+            if (_captures[i]._open)
+                _captures[i]._text.append(chars, length);
+        }
+    }
+
+    virtual void fatalError(const SAXParseException& e) {
+        std::ostringstream err;
+        xerces::string x(e.getMessage());
+        err << x.get_string() << " at line " << e.getLineNumber();
+        throw std::runtime_error(err.str().c_str());
+    }
+
+    size_t matches() const {
+        return _matches;
+    }
+
+    bool stopped() const {
+        return _stopped;
+    }
+
+private:
+
+    struct capture_t {
+        size_t _depth;
+        /** @brief Element has not ended yet */
+        bool _open;
+        xstring_t _text;
+    };
+
+    static void add_state(std::vector<size_t>& states, size_t s) {
+        if (std::find(states.begin(), states.end(), s) == states.end())
+            states.push_back(s);
+    }
+
+    static bool match(const xpath_stream::step_t& step
+            , const XMLCh* const qname
+            , const Attributes& attrs) {
+
+        if (!step._name.empty() && step._name.compare(qname) != 0)
+            return false;
+
+        for (size_t i = 0; i < step._predicates.size(); ++i) {
+            const xpath_stream::predicate_t& p = step._predicates[i];
+            const XMLCh* value = attrs.getValue(p._attribute.c_str());
+            if (value == 0)
+                return false;
+            if (p._has_value && p._value.compare(value) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    void emit(const XMLCh* value) {
+        ++_matches;
+        xerces::string x(value);
+        if (!_handler(x.get_string()))
+            _stopped = true;
+    }
+
+    const std::vector<xpath_stream::step_t>& _steps;
+    const xstring_t& _attribute;
+    xpath_stream::handler_t& _handler;
+
+    /** @brief Steps looked for by children of open elements */
+    std::vector<std::vector<size_t> > _states;
+
+    /** @brief Matched elements in document order, waiting for their end
+     * or for the end of enclosing match */
+    std::deque<capture_t> _captures;
+
+    size_t _depth;
+    size_t _matches;
+    bool _stopped;
+};
+
+/** @brief Collects matches up to the limit */
+struct collector_t {
+    std::vector<std::string>* _result;
+    size_t _max_count;
+
+    bool operator()(const std::string& value) {
+        _result->push_back(value);
+        return _max_count == 0 || _result->size() < _max_count;
+    }
+};
+
+}
+
+//---------------------------------------------------------------
+xpath_stream::xpath_stream(const char* expr) {
+    const std::string s(expr ? expr : "");
+    if (s.empty() || s[0] != '/')
+        unsupported(s);
+
+    size_t pos = 0;
+    while (pos < s.size()) {
+        if (s[pos] != '/')
+            unsupported(s);
+
+        bool descendant = false;
+        if (++pos < s.size() && s[pos] == '/') {
+            descendant = true;
+            ++pos;
+        }
+
+        if (pos < s.size() && s[pos] == '@') {
+            // attribute step must be the last child step
+            const std::string name = s.substr(pos + 1);
+            if (descendant || _steps.empty() || name.empty()
+                    || name.find_first_of("/[]@*") != std::string::npos)
+                unsupported(s);
+            _attribute = to_xstring(name);
+            break;
+        }
+
+        step_t step;
+        step._descendant = descendant;
+        pos = parse_step(s, pos, step);
+        _steps.push_back(step);
+    }
+
+    if (_steps.empty())
+        unsupported(s);
+}
+
+//---------------------------------------------------------------
+size_t xpath_stream::parse_step(const std::string& expr, size_t pos, step_t& step) {
+    const size_t name_end = expr.find_first_of("/[", pos);
+    const std::string name = expr.substr(pos, name_end - pos);
+    if (name.empty() || name.find_first_of("]@=()'\"") != std::string::npos)
+        unsupported(expr);
+    if (name != "*")
+        step._name = to_xstring(name);
+
+    pos = (name_end == std::string::npos) ? expr.size() : name_end;
+    while (pos < expr.size() && expr[pos] == '[') {
+        // [@attr] or [@attr='value']
+        if (++pos >= expr.size() || expr[pos] != '@')
+            unsupported(expr);
+
+        const size_t attr_end = expr.find_first_of("=]", ++pos);
+        if (attr_end == std::string::npos || attr_end == pos)
+            unsupported(expr);
+
+        predicate_t predicate;
+        predicate._attribute = to_xstring(expr.substr(pos, attr_end - pos));
+        predicate._has_value = (expr[attr_end] == '=');
+        pos = attr_end;
+
+        if (predicate._has_value) {
+            const char quote = (++pos < expr.size()) ? expr[pos] : 0;
+            if (quote != '\'' && quote != '"')
+                unsupported(expr);
+            const size_t value_end = expr.find(quote, ++pos);
+            if (value_end == std::string::npos)
+                unsupported(expr);
+            predicate._value = to_xstring(expr.substr(pos, value_end - pos));
+            pos = value_end + 1;
+        }
+
+        if (pos >= expr.size() || expr[pos] != ']')
+            unsupported(expr);
+        ++pos;
+        step._predicates.push_back(predicate);
+    }
+    return pos;
+}
+
+//---------------------------------------------------------------
+template <typename Source>
+size_t xpath_stream::parse(const Source& source, handler_t handler) const {
+    boost::scoped_ptr<SAX2XMLReader> reader(XMLReaderFactory::createXMLReader());
+
+    // element names are compared literally
+    reader->setFeature(XMLUni::fgSAX2CoreNameSpaces, false);
+    reader->setFeature(XMLUni::fgSAX2CoreValidation, false);
+
+    stream_handler stream(_steps, _attribute, handler);
+    reader->setContentHandler(&stream);
+    reader->setErrorHandler(&stream);
+
+    // progressive parse, so handler can stop it at any match
+    XMLPScanToken token;
+    if (!reader->parseFirst(source, token))
+        return stream.matches();
+
+    while (!stream.stopped() && reader->parseNext(token)) { }
+
+    if (stream.stopped())
+        reader->parseReset(token);
+    return stream.matches();
+}
+
+//---------------------------------------------------------------
+size_t xpath_stream::evaluate(const char* filename, handler_t handler) const {
+    return parse(filename, handler);
+}
+
+//---------------------------------------------------------------
+size_t xpath_stream::evaluate(const InputSource& source, handler_t handler) const {
+    return parse(source, handler);
+}
+
+//---------------------------------------------------------------
+std::vector<std::string> xpath_stream::select(const char* filename
+        , size_t max_count/* = 0*/) const {
+    std::vector<std::string> result;
+    collector_t collector = { &result, max_count };
+    evaluate(filename, collector);
+    return result;
+}
@@ -1,7 +1,12 @@
 #include <iostream>
 #include <fstream>
 #include <cassert>
+#include <climits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/dom/DOMWriter.hpp>
@@ -15,8 +20,16 @@
 #include <gtest/gtest.h>
 #include <boost/smart_ptr/shared_ptr.hpp>
 
+#include "xmlutils/platform.h"
 #include "xmlutils/dom_document.h"
+#include "xmlutils/grammar_cache.h"
 #include "xmlutils/xpath.h"
+#include "xmlutils/mapped_file.h"
+#include "xmlutils/snapshot.h"
+#include "xmlutils/xpath_stream.h"
+#include "xmlutils/xpath_executor.h"
+#include "xmlutils/stats.h"
+#include "xmlutils/async_pool.h"
 
 XERCES_CPP_NAMESPACE_USE
         using namespace std;
@@ -24,31 +37,39 @@ XERCES_CPP_NAMESPACE_USE
 // test plan:
 //
 
-class xerces_wrapper_test : public ::testing::Test
+// platform is initialized once for all tests
+class platform_environment : public ::testing::Environment
 {
-protected:
+public:
     virtual void SetUp() {
-        // create XML file working copy
-        XMLPlatformUtils::Initialize();
+        _platform.reset(new xerces::platform(xerces::platform::transformer_component));
     }
 
     virtual void TearDown() {
-        XMLPlatformUtils::Terminate();
+        _platform.reset();
     }
 
+private:
+    boost::scoped_ptr<xerces::platform> _platform;
 };
 
-class xpath_wrapper_test : public ::testing::Test
+::testing::Environment* const g_platform_environment =
+    ::testing::AddGlobalTestEnvironment(new platform_environment);
+
+class xerces_wrapper_test : public ::testing::Test
 {
 protected:
-    virtual void SetUp() {
-        // create XML file working copy
-    }
+    xerces_wrapper_test() : _platform(xerces::platform::xerces_component) { }
 
-    virtual void TearDown() {
-        // delete working copy
-    }
+    xerces::platform _platform;
+};
 
+class xpath_wrapper_test : public ::testing::Test
+{
+protected:
+    xpath_wrapper_test() : _platform(xerces::platform::transformer_component) { }
+
+    xerces::platform _platform;
 };
 
 // 1. Xerces wrappers
@@ -139,3 +160,821 @@ TEST_F(xerces_wrapper_test, create_dom_document)
 
 }
 
+
+// 1.2 Load documents with parsers shared through the pool
+
+TEST_F(xerces_wrapper_test, parser_pool)
+{
+    xerces::dom_parser_pool pool;
+    {
+        xerces::dom_document first("t-sample.xml", pool);
+        xerces::dom_document second("t-sample.xml", pool);
+        second.open_document("t-sample.xml");
+    }
+    ASSERT_EQ( 1u, pool.created() );
+    ASSERT_EQ( 1u, pool.idle() );
+}
+
+// 1.3 Short, long and UTF-8 strings are converted without transcoder
+
+TEST_F(xerces_wrapper_test, xml_string)
+{
+    const std::string name("server_settings");
+    const std::string value(200, 'x');
+    const std::string utf8("\xd0\xbd\xd0\xb0\xf0\x9f\x98\x80");
+
+    xerces::string xname(name.c_str());
+    xerces::string xvalue(value.c_str());
+    xerces::string xutf8(utf8.c_str(), xerces::string::utf8);
+    xerces::string xcopy(xvalue);
+
+    ASSERT_EQ( name, xname.get_string() );
+    ASSERT_EQ( value, xcopy.get_string() );
+    ASSERT_EQ( 4u, xutf8.length() );
+    ASSERT_EQ( utf8, xutf8.get_utf8() );
+
+    // lead bytes above 0xF4 are replaced like stray continuation bytes
+    xerces::string xinvalid("\xf8\x80\x80", xerces::string::utf8);
+    ASSERT_EQ( 3u, xinvalid.length() );
+    for (size_t i = 0; i < xinvalid.length(); ++i)
+        ASSERT_EQ( 0xFFFD, xinvalid.get_wchar()[i] );
+    ASSERT_FALSE( XMLString::compareIString(xname.get_wchar(), xerces::string(xname).get_wchar()) );
+}
+
+// 1.4 Build nodes with interned names
+
+TEST_F(xerces_wrapper_test, interned_names)
+{
+    xerces::dom_document domDocument;
+    xerces::name_table::name srv = domDocument.intern("server_settings");
+    ASSERT_EQ( srv.get(), domDocument.intern("server_settings").get() );
+
+    DOMElement* n1 = domDocument.create_node(srv, "127.0.0.1");
+    DOMElement* n2 = domDocument.create_node("server_settings", "192.168.68.1");
+    domDocument.create_attribute(n1, domDocument.intern("port"), "8080");
+
+    xerces::string xval("192.168.68.1");
+    ASSERT_FALSE( XMLString::compareIString(n1->getTagName(), n2->getTagName()) );
+    ASSERT_FALSE( XMLString::compareIString(n2->getTextContent(), xval.get_wchar()) );
+
+    // names are interned per encoding
+    xerces::name_table names;
+    xerces::name_table::name local = names.intern("port");
+    ASSERT_TRUE( local.get() != names.intern("port", true).get() );
+    ASSERT_EQ( local.get(), names.intern("port").get() );
+    ASSERT_EQ( 2u, names.size() );
+}
+
+// 1.5 Document memory is taken from its own arena
+
+TEST_F(xerces_wrapper_test, arena_memory)
+{
+    xerces::dom_document domDocument("t-sample.xml", xerces::arena_memory);
+    ASSERT_TRUE( domDocument.memory_manager() != XMLPlatformUtils::fgMemoryManager );
+
+    DOMElement* n1 = domDocument.create_node("server_settings", "10.0.0.1");
+    domDocument.create_attribute(n1, "port", "8080");
+    ASSERT_TRUE( n1 );
+
+    // arena is replaced on reload, document is usable again
+    domDocument.open_document("t-sample.xml");
+    DOMElement* n2 = domDocument.create_node("stub_settings");
+    ASSERT_TRUE( n2 );
+    ASSERT_EQ( std::string("stub_settings"), xerces::string(n2->getNodeName()).get_string() );
+
+    // failed reload keeps the document and its arena
+    const std::string malformed("<root><server_settings></root>");
+    domDocument.open_document(reinterpret_cast<const XMLByte*>(malformed.data()), malformed.size());
+    ASSERT_TRUE( domDocument.document() != 0 );
+    ASSERT_TRUE( domDocument.create_node("color_settings") != 0 );
+}
+
+// 1.6 Nested platform guards are reference-counted
+
+TEST_F(xerces_wrapper_test, platform_guard)
+{
+    typedef xerces::platform platform;
+    const size_t refs = platform::references(platform::xerces_component);
+    const size_t inits = platform::initializations(platform::xerces_component);
+    const size_t xpath_inits = platform::initializations(platform::xpath_component);
+    {
+        platform p1;
+        platform p2;
+        ASSERT_EQ( refs + 2, platform::references(platform::xerces_component) );
+        ASSERT_EQ( 2u, platform::references(platform::xpath_component) );
+        ASSERT_EQ( xpath_inits + 1, platform::initializations(platform::xpath_component) );
+    }
+    ASSERT_EQ( refs, platform::references(platform::xerces_component) );
+    ASSERT_EQ( 0u, platform::references(platform::xpath_component) );
+
+    // Xerces is held by the test environment and never initialized again
+    ASSERT_EQ( inits, platform::initializations(platform::xerces_component) );
+}
+
+// 1.7 Serialize to memory, descriptor and atomically replaced file
+
+TEST_F(xerces_wrapper_test, serializer)
+{
+    xerces::dom_document domDocument;
+    DOMElement* n1 = domDocument.create_node("server_settings", "127.0.0.1");
+    domDocument.create_attribute(n1, "port", "8080");
+
+    std::string pretty;
+    const size_t pretty_size = domDocument.save_to(pretty);
+    ASSERT_EQ( pretty.size(), pretty_size );
+
+    domDocument.serializer().set_format(xerces::dom_serializer::compact);
+    std::string compact;
+    domDocument.save_to(compact);
+    ASSERT_LT( compact.size(), pretty.size() );
+    ASSERT_NE( std::string::npos, compact.find("<root><server_settings port=\"8080\">127.0.0.1</server_settings></root>") );
+
+    const int fd = ::open("t-serializer.xml", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE( fd, 0 );
+    ASSERT_EQ( compact.size(), domDocument.save_to(fd) );
+    ::close(fd);
+
+    domDocument.save_document_as("t-serializer.xml");
+    xerces::dom_document reloaded("t-serializer.xml");
+    std::string copy;
+    reloaded.serializer().set_format(xerces::dom_serializer::compact);
+    reloaded.save_to(copy);
+    ASSERT_EQ( compact, copy );
+
+    // plain save writes through symbolic link, atomic one replaces it
+    ::unlink("t-serializer-link.xml");
+    ASSERT_EQ( 0, ::symlink("t-serializer.xml", "t-serializer-link.xml") );
+    struct stat st;
+    domDocument.save_document_as("t-serializer-link.xml");
+    ASSERT_EQ( 0, ::lstat("t-serializer-link.xml", &st) );
+    ASSERT_TRUE( S_ISLNK(st.st_mode) );
+    domDocument.save_document_as("t-serializer-link.xml", true);
+    ASSERT_EQ( 0, ::lstat("t-serializer-link.xml", &st) );
+    ASSERT_TRUE( S_ISREG(st.st_mode) );
+
+    // new file gets mode of the umask
+    ::unlink("t-serializer-new.xml");
+    const mode_t mask = ::umask(022);
+    domDocument.save_document_as("t-serializer-new.xml", true);
+    ::umask(mask);
+    ASSERT_EQ( 0, ::stat("t-serializer-new.xml", &st) );
+    ASSERT_EQ( 0644u, st.st_mode & 07777u );
+}
+
+// 1.8 Append many elements with attributes in one call
+
+TEST_F(xerces_wrapper_test, append_nodes)
+{
+    xerces::dom_document domDocument;
+    DOMElement* servers = domDocument.create_node("servers");
+
+    xerces::node_batch batch;
+    batch.reserve(3, 3);
+    batch.add("server_settings", "127.0.0.1").attribute("port", "8080");
+    batch.add("server_settings", "192.168.68.1").attribute("port", "8081");
+    batch.add("stub_settings");
+    ASSERT_THROW( xerces::node_batch().attribute("port", "0"), std::logic_error );
+
+    std::vector<DOMElement*> created;
+    ASSERT_EQ( 3u, domDocument.append_nodes(batch, servers, &created) );
+    ASSERT_EQ( 3u, created.size() );
+    ASSERT_EQ( 3u, servers->getChildNodes()->getLength() );
+
+    std::string xml;
+    domDocument.serializer().set_format(xerces::dom_serializer::compact);
+    domDocument.save_to(xml);
+    ASSERT_NE( std::string::npos, xml.find("<servers><server_settings port=\"8080\">127.0.0.1</server_settings>"
+        "<server_settings port=\"8081\">192.168.68.1</server_settings><stub_settings/></servers>") );
+}
+
+// 1.9 Clean document is not saved, changes are counted per subtree
+
+TEST_F(xerces_wrapper_test, dirty_tracking)
+{
+    {
+        xerces::dom_document domDocument;
+        domDocument.create_node("server_settings", "127.0.0.1");
+        domDocument.save_document_as("t-dirty.xml");
+    }
+    xerces::dom_document domDocument("t-dirty.xml");
+    ASSERT_FALSE( domDocument.is_dirty() );
+    ASSERT_EQ( 0u, domDocument.save_document() );
+
+    DOMElement* colors = domDocument.create_node("color_settings");
+    const size_t revision = domDocument.revision();
+    domDocument.create_node("line", "0xffccff00", colors);
+    domDocument.create_attribute(colors, "background", "0xff00cc00");
+    ASSERT_EQ( revision + 2, domDocument.revision() );
+    ASSERT_EQ( 1u, domDocument.changed_subtrees() );
+
+    // change made with Xerces API directly
+    domDocument.mark_dirty(0);
+    ASSERT_EQ( 2u, domDocument.changed_subtrees() );
+
+    ASSERT_EQ( 2u, domDocument.save_document() );
+    ASSERT_FALSE( domDocument.is_dirty() );
+    ASSERT_EQ( 0u, domDocument.save_document() );
+
+    domDocument.delete_node(colors);
+    ASSERT_TRUE( domDocument.is_dirty() );
+    ASSERT_EQ( 1u, domDocument.changed_subtrees() );
+
+    // deleted subtree is not counted as changed
+    DOMElement* removed = domDocument.create_node("removed_settings");
+    ASSERT_EQ( 2u, domDocument.changed_subtrees() );
+    domDocument.delete_node(removed);
+    ASSERT_EQ( 1u, domDocument.changed_subtrees() );
+
+    // failed reload keeps unsaved changes
+    const size_t before = domDocument.revision();
+    const std::string malformed("<root><server_settings></root>");
+    domDocument.open_document(reinterpret_cast<const XMLByte*>(malformed.data()), malformed.size());
+    ASSERT_TRUE( domDocument.is_dirty() );
+    ASSERT_EQ( before, domDocument.revision() );
+}
+
+// 1.10 Validate against preloaded schema, pooled and local parsers
+
+TEST_F(xerces_wrapper_test, grammar_cache)
+{
+    xerces::grammar_cache grammars;
+    grammars.preload_schema("t-sample.xsd");
+    grammars.lock();
+    ASSERT_EQ( 1u, grammars.preloaded() );
+    ASSERT_THROW( grammars.preload_schema("t-sample.xsd"), std::logic_error );
+
+    const xerces::parse_options options = xerces::parse_options::validated(&grammars);
+    xerces::dom_document domDocument("t-sample.xml", options);
+
+    const std::string invalid("<root><unknown_settings/></root>");
+    ASSERT_THROW( domDocument.open_document(reinterpret_cast<const XMLByte*>(invalid.data())
+            , invalid.size(), options), std::runtime_error );
+    // not validated by default
+    domDocument.open_document(reinterpret_cast<const XMLByte*>(invalid.data()), invalid.size());
+
+    xerces::dom_parser_pool pool(2, &grammars);
+    xerces::dom_document pooled("t-sample.xml", pool, options);
+    ASSERT_EQ( 1u, pool.created() );
+}
+
+// 1.11 Element name and attribute value indexes follow document changes
+
+TEST_F(xerces_wrapper_test, node_index)
+{
+    xerces::dom_document domDocument("t-sample.xml");
+    ASSERT_THROW( domDocument.elements_by_name("server_settings"), std::logic_error );
+
+    domDocument.enable_index(std::vector<std::string>(1, "line_color"));
+    ASSERT_EQ( 2u, domDocument.elements_by_name("server_settings").size() );
+    ASSERT_EQ( 1u, domDocument.elements_by_attribute("line_color", "0xffccff00").size() );
+    // not indexed attribute
+    ASSERT_TRUE( domDocument.elements_by_attribute("background_color", "0xff00cc00").empty() );
+
+    DOMElement* srv = domDocument.create_node("server_settings", "10.0.0.1");
+    ASSERT_EQ( 3u, domDocument.elements_by_name("server_settings").size() );
+    ASSERT_EQ( srv, domDocument.elements_by_name("server_settings").back() );
+
+    DOMElement* colors = domDocument.elements_by_attribute("line_color", "0xffccff00").front();
+    domDocument.set_attribute_value(colors, "line_color", "0xff000000");
+    ASSERT_TRUE( domDocument.elements_by_attribute("line_color", "0xffccff00").empty() );
+    ASSERT_EQ( colors, domDocument.elements_by_attribute("line_color", "0xff000000").front() );
+
+    domDocument.delete_node(colors);
+    ASSERT_TRUE( domDocument.elements_by_name("color_settings").empty() );
+    ASSERT_TRUE( domDocument.elements_by_attribute("line_color", "0xff000000").empty() );
+
+    // removed element leaves no hole, order is kept
+    DOMElement* second = domDocument.elements_by_name("server_settings")[1];
+    domDocument.delete_node(domDocument.elements_by_name("server_settings").front());
+    DOMElement* last = domDocument.create_node("server_settings", "10.0.0.2");
+    const xerces::node_index::element_list_t& servers = domDocument.elements_by_name("server_settings");
+    ASSERT_EQ( 3u, servers.size() );
+    ASSERT_EQ( second, servers[0] );
+    ASSERT_EQ( srv, servers[1] );
+    ASSERT_EQ( last, servers[2] );
+
+    domDocument.open_document("t-sample.xml");
+    ASSERT_EQ( 2u, domDocument.elements_by_name("server_settings").size() );
+    ASSERT_EQ( 1u, domDocument.elements_by_name("root").size() );
+}
+
+// 1.12 Compiled snapshot answers queries like the parsed document, stale and corrupted are rejected
+
+TEST_F(xerces_wrapper_test, snapshot)
+{
+    ASSERT_LT( 0u, xerces::snapshot::compile("t-sample.xml", "t-sample.snap") );
+
+    xerces::snapshot settings("t-sample.snap", "t-sample.xml");
+    const std::vector<std::string> servers = settings.evaluate("/root/server_settings/text()");
+    ASSERT_EQ( 2u, servers.size() );
+    ASSERT_EQ( "127.0.0.1", servers[0] );
+    ASSERT_EQ( "192.168.68.1", servers[1] );
+    ASSERT_EQ( "0xffccff00", settings.evaluate("/root/color_settings/@line_color").at(0) );
+    ASSERT_EQ( 4u, settings.evaluate("/root/*").size() );
+    ASSERT_TRUE( settings.evaluate("/root/missing_settings").empty() );
+    ASSERT_THROW( settings.evaluate("//server_settings"), std::runtime_error );
+
+    xerces::snapshot::node_list_t root;
+    settings.select("/root", root);
+    ASSERT_EQ( xerces::snapshot::element_node, settings.kind(root.at(0)) );
+    ASSERT_STREQ( "root", settings.name(root[0]) );
+    ASSERT_EQ( 0u, settings.parent(root[0]) );
+
+    // the source is not the one snapshot was compiled from
+    ASSERT_THROW( xerces::snapshot("t-sample.snap", "t-sample.xsd"), std::runtime_error );
+
+    // source rewritten within the same second keeps its size
+    {
+        std::ofstream out("t-stamp.xml");
+        out << "<root color=\"0xffccff00\"/>";
+    }
+    xerces::snapshot::compile("t-stamp.xml", "t-stamp.snap");
+    // file times advance by the kernel tick
+    ::usleep(20000);
+    {
+        std::ofstream out("t-stamp.xml");
+        out << "<root color=\"0xff000000\"/>";
+    }
+    ASSERT_THROW( xerces::snapshot("t-stamp.snap", "t-stamp.xml"), std::runtime_error );
+
+    {
+        std::ofstream out("t-stamp.xml");
+        out << "<root><server_settings></root>";
+    }
+    ASSERT_THROW( xerces::snapshot::compile("t-stamp.xml", "t-stamp.snap"), std::runtime_error );
+
+    std::string image;
+    {
+        std::ifstream in("t-sample.snap", std::ios::binary);
+        image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    image[image.size() - 2] ^= 0x20;
+    {
+        std::ofstream out("t-corrupted.snap", std::ios::binary);
+        out.write(image.data(), image.size());
+    }
+    ASSERT_THROW( xerces::snapshot("t-corrupted.snap"), std::runtime_error );
+    ASSERT_THROW( xerces::snapshot("t-sample.xml"), std::runtime_error );
+}
+
+// 1.13 Projected load keeps only matched subtrees and the way to them
+
+TEST_F(xerces_wrapper_test, projection)
+{
+    xerces::projection servers;
+    servers.add("/root/server_settings");
+    ASSERT_THROW( servers.add("server_settings"), std::runtime_error );
+    ASSERT_THROW( servers.add("/root/server_settings[1"), std::runtime_error );
+    ASSERT_THROW( servers.add("/root/.."), std::runtime_error );
+    ASSERT_THROW( servers.add("/root/a|/root/b"), std::runtime_error );
+    ASSERT_THROW( servers.add("/root/count(x)"), std::runtime_error );
+    ASSERT_THROW( servers.add("/root/@a|/root/b"), std::runtime_error );
+    servers.add("/child::root/x:server_settings");
+
+    xerces::parse_options options;
+    options._projection = &servers;
+    xerces::dom_document domDocument("t-sample.xml", options);
+
+    const DOMElement* root = domDocument.document()->getDocumentElement();
+    ASSERT_TRUE( root != 0 );
+    size_t children = 0;
+    for (const DOMNode* n = root->getFirstChild(); n != 0; n = n->getNextSibling()) {
+        // whitespace of the root and other settings are dropped
+        ASSERT_EQ( DOMNode::ELEMENT_NODE, n->getNodeType() );
+        ASSERT_EQ( "server_settings", xerces::string(n->getNodeName()).get_string() );
+        ++children;
+    }
+    ASSERT_EQ( 2u, children );
+    ASSERT_EQ( "192.168.68.1", xerces::string(root->getLastChild()->getTextContent()).get_string() );
+
+    // "//" looks through other elements but keeps matched ones only
+    xerces::projection stubs;
+    stubs.add("//stub_settings");
+    options._projection = &stubs;
+    domDocument.open_document("t-sample.xml", options);
+    root = domDocument.document()->getDocumentElement();
+    ASSERT_TRUE( root->getFirstChild() != 0 );
+    ASSERT_TRUE( root->getFirstChild() == root->getLastChild() );
+    ASSERT_EQ( "stub_settings", xerces::string(root->getFirstChild()->getNodeName()).get_string() );
+
+    // empty projection keeps the whole document
+    const xerces::projection all;
+    options._projection = &all;
+    domDocument.open_document("t-sample.xml", options);
+    ASSERT_TRUE( domDocument.document()->getDocumentElement()->getFirstChild()->getNodeType() == DOMNode::TEXT_NODE );
+}
+
+// 2. Xalan wrappers
+// 2.1 Run several queries against the document parsed once
+
+TEST_F(xpath_wrapper_test, evaluate_parsed_once)
+{
+    xerces::xpath x("t-sample.xml", xerces::global_memory);
+
+    x.evaluate("/root/server_settings/text()", "/");
+    ASSERT_EQ( 2u, x.result().size() );
+    ASSERT_EQ( "127.0.0.1", x.result().at(0) );
+    ASSERT_EQ( "192.168.68.1", x.result().at(1) );
+
+    x.reload();
+    x.evaluate("/root/color_settings/@line_color", "/");
+    ASSERT_EQ( "0xffccff00", x.result().back() );
+
+    // arena memory isn't reused, so the evaluator parses once
+    xerces::xpath arena("t-sample.xml", xerces::arena_memory);
+    ASSERT_THROW( arena.reload(), std::logic_error );
+    ASSERT_THROW( arena.open("t-sample.xml"), std::logic_error );
+    ASSERT_EQ( 2u, arena.evaluate("/root/server_settings", "/").size() );
+}
+
+// 2.2 Repeated query is taken from the compiled expressions cache
+
+TEST_F(xpath_wrapper_test, compiled_expression_cache)
+{
+    xerces::xpath x("t-sample.xml");
+    // simple paths are not compiled by the native evaluator
+    x.enable_native(false);
+    x.cache().set_capacity(1);
+
+    x.evaluate("/root/server_settings/text()", "/");
+    x.evaluate("/root/server_settings/text()", "/");
+    ASSERT_EQ( 1u, x.cache().hits() );
+    ASSERT_EQ( 1u, x.cache().misses() );
+
+    // evicts the first pair
+    x.evaluate("/root/color_settings/@line_color", "/");
+    x.evaluate("/root/server_settings/text()", "/");
+    ASSERT_EQ( 3u, x.cache().misses() );
+    ASSERT_EQ( 1u, x.cache().size() );
+}
+
+// 2.3 Load settings profile with a single batch call
+
+TEST_F(xpath_wrapper_test, evaluate_batch)
+{
+    xerces::xpath x("t-sample.xml");
+
+    std::vector<xerces::xpath::query_t> queries;
+    queries.push_back(xerces::xpath::query_t("/root/server_settings/text()", "/"));
+    queries.push_back(xerces::xpath::query_t("/root/color_settings/@line_color", "/"));
+    queries.push_back(xerces::xpath::query_t("@background_color", "/root/color_settings"));
+
+    const xerces::xpath::batch_result_t res = x.evaluate_batch(queries);
+    ASSERT_EQ( 3u, res.size() );
+    ASSERT_EQ( 2u, res[0].size() );
+    ASSERT_EQ( "192.168.68.1", res[0][1] );
+    ASSERT_EQ( "0xffccff00", res[1].at(0) );
+    ASSERT_EQ( "0xff00cc00", res[2].at(0) );
+}
+
+// 2.4 Typed values are converted without intermediate strings
+
+TEST_F(xpath_wrapper_test, typed_result)
+{
+    xerces::xpath x("t-sample.xml");
+
+    const xerces::xpath_result& res = x.evaluate("count(/root/server_settings)", "/");
+    ASSERT_FALSE( res.is_nodeset() );
+    ASSERT_EQ( 2.0, res.number() );
+
+    x.evaluate("/root/server_settings/text()", "/");
+    ASSERT_EQ( 2u, x.result().size() );
+    x.evaluate("/root/stub_settings", "/");
+    ASSERT_EQ( 1u, x.result().size() );
+    ASSERT_TRUE( x.typed_result().node(0) != 0 );
+
+    ASSERT_EQ( 0xffccff00u,
+        xerces::evaluate_xpath<unsigned int>(x, "/root/color_settings/@line_color") );
+    ASSERT_EQ( 2, xerces::evaluate_xpath<int>(x, "count(/root/server_settings)") );
+    ASSERT_THROW( xerces::evaluate_xpath<int>(x, "/root/server_settings/text()"),
+        std::runtime_error );
+}
+
+// 2.5 Query mapped file without intermediate copy
+
+TEST_F(xpath_wrapper_test, evaluate_mapped_file)
+{
+    xerces::mapped_file file("t-sample.xml");
+    xerces::xpath x(file.data(), file.size());
+
+    x.evaluate("/root/server_settings/text()", "/");
+    ASSERT_EQ( 2u, x.result().size() );
+
+    xerces::dom_document domDocument(file.data(), file.size());
+
+    // sizes above 32 bits are not truncated
+    if (sizeof(size_t) > sizeof(unsigned int)) {
+        const size_t huge = static_cast<size_t>(UINT_MAX) + 1;
+        ASSERT_THROW( xerces::xpath(file.data(), huge), std::length_error );
+        ASSERT_THROW( domDocument.open_document(file.data(), huge), std::length_error );
+        ASSERT_TRUE( domDocument.document() != 0 );
+    }
+}
+
+// 2.6 Streaming evaluation stops at the first match
+
+TEST_F(xpath_wrapper_test, evaluate_stream)
+{
+    xerces::xpath_stream servers("//server_settings");
+    std::vector<std::string> res = servers.select("t-sample.xml");
+    ASSERT_EQ( 2u, res.size() );
+    ASSERT_EQ( "192.168.68.1", res[1] );
+
+    res = servers.select("t-sample.xml", 1);
+    ASSERT_EQ( 1u, res.size() );
+    ASSERT_EQ( "127.0.0.1", res[0] );
+
+    xerces::xpath_stream color("/root/color_settings[@line_color='0xffccff00']/@background_color");
+    res = color.select("t-sample.xml");
+    ASSERT_EQ( 1u, res.size() );
+    ASSERT_EQ( "0xff00cc00", res[0] );
+
+    ASSERT_THROW( xerces::xpath_stream("count(//server_settings)"), std::runtime_error );
+
+    // nested matches keep document order
+    {
+        std::ofstream out("t-nested.xml");
+        out << "<root><a>1<a>2</a></a><a>3</a></root>";
+    }
+    xerces::xpath_stream nested("//a");
+    res = nested.select("t-nested.xml");
+    ASSERT_EQ( 3u, res.size() );
+    ASSERT_EQ( "12", res[0] );
+    ASSERT_EQ( "2", res[1] );
+    ASSERT_EQ( "3", res[2] );
+    res = nested.select("t-nested.xml", 1);
+    ASSERT_EQ( 1u, res.size() );
+    ASSERT_EQ( "12", res[0] );
+}
+
+// 2.7 Run queries over many files in parallel, results keep input order
+
+TEST_F(xpath_wrapper_test, parallel_executor)
+{
+    {
+        std::ofstream out("t-malformed.xml");
+        out << "<root><server_settings></root>";
+    }
+    std::vector<std::string> files(7, "t-sample.xml");
+    files[3] = "missing.xml";
+    files[5] = "t-malformed.xml";
+
+    std::vector<xerces::xpath::query_t> queries;
+    queries.push_back(xerces::xpath::query_t("/root/server_settings/text()", "/"));
+    queries.push_back(xerces::xpath::query_t("/root/color_settings/@line_color", "/"));
+
+    xerces::xpath_executor executor(3);
+    ASSERT_EQ( 3u, executor.threads() );
+
+    xerces::xpath_executor::result_t res = executor.run(files, queries);
+    ASSERT_EQ( files.size(), res.size() );
+    for (size_t i = 0; i < res.size(); ++i) {
+        ASSERT_EQ( files[i], res[i]._filename );
+        if (i == 3 || i == 5) {
+            ASSERT_FALSE( res[i]._error.empty() );
+            // parse error keeps its message
+            ASSERT_NE( "Generic error occur", res[i]._error );
+            continue;
+        }
+        ASSERT_TRUE( res[i]._error.empty() );
+        ASSERT_EQ( 2u, res[i]._results.size() );
+        ASSERT_EQ( "192.168.68.1", res[i]._results[0][1] );
+        ASSERT_EQ( "0xffccff00", res[i]._results[1][0] );
+    }
+}
+
+// 2.8 Phase timers and counters are collected, unless compiled out
+
+TEST_F(xpath_wrapper_test, stats)
+{
+    using namespace xerces::stats;
+    const snapshot_t before = snapshot();
+
+    xerces::xpath x("t-sample.xml");
+    x.evaluate("/root/server_settings/text()", "/");
+    ASSERT_EQ( 2u, x.result().size() );
+
+    const snapshot_t after = snapshot();
+#ifdef XMLUTILS_STATS
+    ASSERT_EQ( before._counters[documents_parsed] + 1, after._counters[documents_parsed] );
+    ASSERT_LT( before._counters[bytes_read], after._counters[bytes_read] );
+    ASSERT_EQ( before._counters[nodes_returned] + 2, after._counters[nodes_returned] );
+    ASSERT_EQ( before._phase_calls[execute_phase] + 1, after._phase_calls[execute_phase] );
+    ASSERT_EQ( before._phase_calls[transcode_phase] + 1, after._phase_calls[transcode_phase] );
+#else
+    ASSERT_EQ( 0u, after._counters[documents_parsed] );
+#endif
+    ASSERT_STREQ( "parse", phase_name(parse_phase) );
+    ASSERT_STREQ( "transcode_calls", counter_name(transcode_calls) );
+}
+
+// 2.9 Query loaded document in place, unsaved changes are visible
+
+TEST_F(xpath_wrapper_test, evaluate_dom_document)
+{
+    xerces::dom_document domDocument("t-sample.xml");
+    xerces::xpath x(domDocument);
+
+    x.evaluate("/root/server_settings/text()", "/");
+    ASSERT_EQ( 2u, x.result().size() );
+
+    domDocument.create_node("server_settings", "10.0.0.1");
+    x.evaluate("/root/server_settings/text()", "/");
+    ASSERT_EQ( 3u, x.result().size() );
+    ASSERT_EQ( "10.0.0.1", x.result()[2] );
+
+    ASSERT_EQ( "0xffccff00", xerces::evaluate_xpath<std::string>(x, "/root/color_settings/@line_color") );
+
+    // document which failed to load can't be queried
+    const std::string malformed("<root><server_settings></root>");
+    xerces::dom_document broken(reinterpret_cast<const XMLByte*>(malformed.data()), malformed.size());
+    ASSERT_TRUE( broken.document() == 0 );
+    ASSERT_THROW( xerces::xpath unloaded(broken), std::runtime_error );
+}
+
+// 2.10 Start loads and queries at once, collect futures and callbacks
+
+namespace {
+void store_error(std::string* out, const xerces::xpath::batch_result_t&, const std::string& error) {
+    *out = error;
+}
+}
+
+TEST_F(xpath_wrapper_test, async_pool)
+{
+    std::vector<xerces::xpath::query_t> queries;
+    queries.push_back(xerces::xpath::query_t("/root/server_settings/text()", "/"));
+
+    {
+        std::ofstream out("t-malformed.xml");
+        out << "<root><server_settings></root>";
+    }
+
+    std::string callback_error;
+    {
+        xerces::async_pool pool(2, 2);
+        ASSERT_EQ( 2u, pool.threads() );
+
+        boost::unique_future<xerces::async_pool::document_ptr> doc
+                = pool.open_document_async("t-sample.xml");
+        boost::unique_future<xerces::xpath::batch_result_t> file
+                = pool.evaluate_async("t-sample.xml", queries);
+        std::vector<xerces::xpath::query_t> invalid(1, xerces::xpath::query_t("/root[", "/"));
+        boost::unique_future<xerces::xpath::batch_result_t> error
+                = pool.evaluate_async("t-sample.xml", invalid);
+        pool.evaluate_async("missing.xml", queries
+                , boost::bind(&store_error, &callback_error, _1, _2));
+
+        xerces::async_pool::document_ptr d = doc.get();
+        ASSERT_TRUE( d->document() != 0 );
+        ASSERT_EQ( 2u, file.get()[0].size() );
+        ASSERT_THROW( error.get(), std::runtime_error );
+
+        boost::unique_future<xerces::xpath::batch_result_t> loaded
+                = pool.evaluate_async(d, queries);
+        ASSERT_EQ( "192.168.68.1", loaded.get()[0][1] );
+
+        // parse errors are delivered like other errors
+        boost::unique_future<xerces::async_pool::document_ptr> malformed
+                = pool.open_document_async("t-malformed.xml");
+        ASSERT_THROW( malformed.get(), std::runtime_error );
+        boost::unique_future<xerces::xpath::batch_result_t> unparsed
+                = pool.evaluate_async("t-malformed.xml", queries);
+        ASSERT_THROW( unparsed.get(), std::runtime_error );
+    }
+    // queued tasks are finished by the pool destructor
+    ASSERT_FALSE( callback_error.empty() );
+}
+
+// 2.11 Absolute paths are answered by the path index like by Xalan
+
+TEST_F(xpath_wrapper_test, path_index)
+{
+    const char* const paths[] = {
+        "/root/server_settings/text()",
+        "/root/color_settings/@line_color",
+        "/root/server_settings",
+        "/root/missing_settings"
+    };
+    const size_t count = sizeof(paths) / sizeof(paths[0]);
+
+    xerces::xpath plain("t-sample.xml");
+    plain.enable_native(false);
+    xerces::xpath indexed("t-sample.xml", xerces::global_memory);
+    indexed.enable_path_index();
+    ASSERT_TRUE( indexed.path_indexed() );
+    ASSERT_LT( 0u, indexed.path_index_memory() );
+
+    for (size_t i = 0; i < count; ++i) {
+        plain.evaluate(paths[i], "/");
+        indexed.evaluate(paths[i], "/");
+        ASSERT_EQ( plain.result(), indexed.result() ) << paths[i];
+    }
+    // nothing is compiled for indexed paths
+    ASSERT_EQ( 0u, indexed.cache().size() );
+
+    // other queries fall back to Xalan
+    ASSERT_EQ( 2.0, indexed.evaluate("count(/root/server_settings)", "/").number() );
+    ASSERT_EQ( 1u, indexed.cache().size() );
+
+    // index is rebuilt on reload
+    indexed.reload();
+    ASSERT_EQ( "192.168.68.1", indexed.evaluate("/root/server_settings/text()", "/").string(1) );
+
+    // unprefixed paths do not match elements of default namespace
+    const std::string qualified =
+            "<root><a/><b xmlns=\"urn:x\"><a/></b><c xmlns=\"urn:x\"/></root>";
+    xerces::xpath namespaced(reinterpret_cast<const XMLByte*>(qualified.data()), qualified.size());
+    namespaced.enable_path_index();
+    ASSERT_EQ( 1u, namespaced.evaluate("/root/a", "/").size() );
+    ASSERT_EQ( 0u, namespaced.evaluate("/root/b", "/").size() );
+    ASSERT_EQ( 0u, namespaced.evaluate("/root/b/a", "/").size() );
+    ASSERT_EQ( 0u, namespaced.evaluate("/root/c", "/").size() );
+    ASSERT_EQ( 0u, namespaced.cache().size() );
+}
+
+// 2.12 Simple paths are evaluated natively like by Xalan
+
+TEST_F(xpath_wrapper_test, native_evaluator)
+{
+    const char* const queries[][2] = {
+        { "/root/server_settings/text()", "/" },
+        { "//server_settings", "/" },
+        { "@line_color", "/root/color_settings" },
+        { "//@line_color", "/" },
+        { "/root/*", "/" },
+        { "//text()", "/" },
+        { "server_settings", "/root" },
+        { "/root/missing_settings", "/" },
+        { "/", "/" }
+    };
+    const size_t count = sizeof(queries) / sizeof(queries[0]);
+
+    xerces::xpath xalan("t-sample.xml");
+    xalan.enable_native(false);
+    xerces::xpath native("t-sample.xml");
+    ASSERT_TRUE( native.native() );
+
+    for (size_t i = 0; i < count; ++i) {
+        xalan.evaluate(queries[i][0], queries[i][1]);
+        native.evaluate(queries[i][0], queries[i][1]);
+        ASSERT_EQ( xalan.result(), native.result() ) << queries[i][0];
+    }
+    // nothing is compiled for simple paths
+    ASSERT_EQ( 0u, native.cache().size() );
+
+    // other queries fall back to Xalan
+    ASSERT_EQ( "127.0.0.1", native.evaluate("/root/server_settings[1]/text()", "/").string(0) );
+    ASSERT_EQ( 1u, native.cache().size() );
+    ASSERT_THROW( native.evaluate("text()", "/root/missing_settings"), std::runtime_error );
+
+    // namespaces, nested elements of the same name and CDATA
+    const char* const tricky[][2] = {
+        { "//a", "/" },
+        { "//a/b", "/" },
+        { "//a/text()", "/" },
+        { "/root/a/a", "/" },
+        { "//b", "/" },
+        { "/root/b/a", "/" },
+        { "/root/*", "/" },
+        { "//text()", "/" },
+        { "text()", "/root/c" },
+        { "@p:id", "/root/c" },
+        { "@id", "/root/c" }
+    };
+    const size_t tricky_count = sizeof(tricky) / sizeof(tricky[0]);
+    const std::string document =
+            "<root xmlns:p=\"urn:p\"><a>1<a>2<b>x</b></a><b>y</b></a><p:a>3</p:a>"
+            "<b xmlns=\"urn:d\"><a/></b><c p:id=\"4\" id=\"5\"><![CDATA[<6>]]>7</c></root>";
+    const XMLByte* const data = reinterpret_cast<const XMLByte*>(document.data());
+
+    xerces::xpath tricky_xalan(data, document.size());
+    tricky_xalan.enable_native(false);
+    xerces::xpath tricky_native(data, document.size());
+    for (size_t i = 0; i < tricky_count; ++i) {
+        tricky_xalan.evaluate(tricky[i][0], tricky[i][1]);
+        tricky_native.evaluate(tricky[i][0], tricky[i][1]);
+        ASSERT_EQ( tricky_xalan.result(), tricky_native.result() ) << tricky[i][0];
+    }
+}
+
+// 2.13 Evaluator parses projected subtrees only
+
+TEST_F(xpath_wrapper_test, projection)
+{
+    std::vector<std::string> patterns;
+    patterns.push_back("/root/color_settings/@line_color");
+    patterns.push_back("//stub_settings");
+    const xerces::projection colors(patterns);
+
+    xerces::xpath x("t-sample.xml", colors, xerces::global_memory);
+    ASSERT_EQ( "0xffccff00", x.evaluate("/root/color_settings/@line_color", "/").string(0) );
+    ASSERT_EQ( 1u, x.evaluate("//stub_settings", "/").size() );
+    // elements looked through by "//" are dropped without kept content
+    ASSERT_EQ( 0u, x.evaluate("/root/server_settings", "/").size() );
+    ASSERT_EQ( 2u, x.evaluate("/root/*", "/").size() );
+
+    x.set_projection(0);
+    x.reload();
+    ASSERT_EQ( 2u, x.evaluate("/root/server_settings", "/").size() );
+}